@@ -9,7 +9,9 @@
 ////// INCLUDES //////
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <utility>
 
 
 #if defined(WELP_ACC_BUFFER_INCLUDE_ALL) || defined(WELP_ALWAYS_INCLUDE_ALL)
@@ -63,6 +65,11 @@ namespace welp
 		inline welp::acc_buffer<Ty, _Allocator>::iterator begin() noexcept { return welp::acc_buffer<Ty, _Allocator>::iterator(data_ptr); }
 		inline welp::acc_buffer<Ty, _Allocator>::iterator end() noexcept { return welp::acc_buffer<Ty, _Allocator>::iterator(current_ptr); }
 
+		// pool_Ty is a welp::threads, or any type with the same parallel_for and parallel_transform_reduce
+		template <class pool_Ty, class function_Ty> void for_each(pool_Ty& pool, function_Ty&& function, std::size_t grain);
+		template <class pool_Ty, class value_Ty, class reduce_Ty, class transform_Ty>
+		value_Ty transform_reduce(pool_Ty& pool, value_Ty init, reduce_Ty&& reduce, transform_Ty&& transform);
+
 		bool new_buffer(std::size_t instances);
 		void delete_buffer() noexcept;
 
@@ -170,6 +177,151 @@ namespace welp
 		};
 	};
 
+	// objects are constructed in place when appended and destroyed when popped, the cells are uninitialised storage otherwise,
+	// there is no by-pointer mode so that the iterators are plain pointers
+	template <class Ty, class _Allocator = std::allocator<char>> class acc_buffer_raw : private _Allocator
+	{
+
+	public:
+
+		inline welp::acc_buffer_raw<Ty, _Allocator>& operator<<(const Ty& obj);
+		inline welp::acc_buffer_raw<Ty, _Allocator>& operator<<(Ty&& obj) noexcept;
+		inline welp::acc_buffer_raw<Ty, _Allocator>& operator<(const Ty& obj);
+		template <class ... _Args> inline welp::acc_buffer_raw<Ty, _Allocator>& emplace_back(_Args&& ... args);
+
+		inline const Ty& operator[](std::size_t offset) const noexcept;
+		inline Ty& operator[](std::size_t offset) noexcept;
+
+		inline std::size_t size() const noexcept;
+		inline std::size_t capacity() const noexcept;
+		inline void pop_back() noexcept;
+		inline void pop_back(std::size_t instances) noexcept;
+		inline void reset() noexcept;
+
+		using iterator = Ty*;
+		using const_iterator = const Ty*;
+		inline iterator begin() noexcept { return data_ptr; }
+		inline iterator end() noexcept { return current_ptr; }
+		inline const_iterator begin() const noexcept { return data_ptr; }
+		inline const_iterator end() const noexcept { return current_ptr; }
+
+		bool new_buffer(std::size_t instances);
+		void delete_buffer() noexcept;
+
+		acc_buffer_raw() = default;
+		acc_buffer_raw(std::size_t instances);
+		acc_buffer_raw(const welp::acc_buffer_raw<Ty, _Allocator>&);
+		welp::acc_buffer_raw<Ty, _Allocator>& operator=(const welp::acc_buffer_raw<Ty, _Allocator>&);
+		acc_buffer_raw(welp::acc_buffer_raw<Ty, _Allocator>&&) noexcept;
+		welp::acc_buffer_raw<Ty, _Allocator>& operator=(welp::acc_buffer_raw<Ty, _Allocator>&&) noexcept;
+		~acc_buffer_raw();
+
+	private:
+
+		char* raw_data_ptr = nullptr;
+		Ty* current_ptr = nullptr;
+		Ty* data_ptr = nullptr;
+		std::size_t max_number_of_cells = 0;
+	};
+
+	// by-pointer mode of acc_buffer, only the pointers are stored and the iterators dereference them
+	template <class Ty, class _Allocator = std::allocator<char>> class acc_buffer_ptr : private _Allocator
+	{
+
+	public:
+
+		inline welp::acc_buffer_ptr<Ty, _Allocator>& operator<<(Ty* const obj_ptr) noexcept;
+
+		inline const Ty& operator[](std::size_t offset) const noexcept;
+		inline Ty& operator[](std::size_t offset) noexcept;
+
+		inline std::size_t size() const noexcept;
+		inline std::size_t capacity() const noexcept;
+		inline void pop_back() noexcept;
+		inline void pop_back(std::size_t instances) noexcept;
+		inline void reset() noexcept;
+
+		class iterator;
+		inline welp::acc_buffer_ptr<Ty, _Allocator>::iterator begin() noexcept { return welp::acc_buffer_ptr<Ty, _Allocator>::iterator(data_ptr); }
+		inline welp::acc_buffer_ptr<Ty, _Allocator>::iterator end() noexcept { return welp::acc_buffer_ptr<Ty, _Allocator>::iterator(current_ptr); }
+
+		bool new_buffer(std::size_t instances);
+		void delete_buffer() noexcept;
+
+		acc_buffer_ptr() = default;
+		acc_buffer_ptr(std::size_t instances);
+		acc_buffer_ptr(const welp::acc_buffer_ptr<Ty, _Allocator>&);
+		welp::acc_buffer_ptr<Ty, _Allocator>& operator=(const welp::acc_buffer_ptr<Ty, _Allocator>&);
+		acc_buffer_ptr(welp::acc_buffer_ptr<Ty, _Allocator>&&) noexcept;
+		welp::acc_buffer_ptr<Ty, _Allocator>& operator=(welp::acc_buffer_ptr<Ty, _Allocator>&&) noexcept;
+		~acc_buffer_ptr();
+
+		class iterator
+		{
+
+		public:
+
+			using value_type = Ty;
+			using pointer = Ty*; using const_pointer = const Ty*;
+			using reference = Ty&; using const_reference = const Ty&;
+			using size_type = std::size_t; using difference_type = std::ptrdiff_t;
+			using iterator_category = std::random_access_iterator_tag;
+
+			inline Ty& operator*() noexcept { return **internal_ptr; }
+			inline Ty* operator->() noexcept { return *internal_ptr; }
+			inline Ty& operator[](std::ptrdiff_t offset) noexcept { return **(internal_ptr + offset); }
+
+			inline welp::acc_buffer_ptr<Ty, _Allocator>::iterator& operator+=(std::ptrdiff_t offset) noexcept { internal_ptr += offset; return *this; }
+			inline welp::acc_buffer_ptr<Ty, _Allocator>::iterator& operator++() noexcept { internal_ptr++; return *this; }
+			inline welp::acc_buffer_ptr<Ty, _Allocator>::iterator operator++(int) noexcept {
+				welp::acc_buffer_ptr<Ty, _Allocator>::iterator temp_iterator = *this;
+				internal_ptr++; return temp_iterator;
+			}
+
+			inline welp::acc_buffer_ptr<Ty, _Allocator>::iterator& operator-=(std::ptrdiff_t offset) noexcept { internal_ptr -= offset; return *this; }
+			inline welp::acc_buffer_ptr<Ty, _Allocator>::iterator& operator--() noexcept { internal_ptr--; return *this; }
+			inline welp::acc_buffer_ptr<Ty, _Allocator>::iterator operator--(int) noexcept {
+				welp::acc_buffer_ptr<Ty, _Allocator>::iterator temp_iterator = *this;
+				internal_ptr--; return temp_iterator;
+			}
+
+			inline welp::acc_buffer_ptr<Ty, _Allocator>::iterator operator+(std::size_t offset) const noexcept {
+				return welp::acc_buffer_ptr<Ty, _Allocator>::iterator(internal_ptr + offset);
+			}
+			inline welp::acc_buffer_ptr<Ty, _Allocator>::iterator operator-(std::size_t offset) const noexcept {
+				return welp::acc_buffer_ptr<Ty, _Allocator>::iterator(internal_ptr - offset);
+			}
+			inline std::ptrdiff_t operator-(const welp::acc_buffer_ptr<Ty, _Allocator>::iterator& rhs) const noexcept {
+				return internal_ptr - rhs.internal_ptr;
+			}
+
+			inline bool operator==(const welp::acc_buffer_ptr<Ty, _Allocator>::iterator& rhs) const noexcept { return internal_ptr == rhs.internal_ptr; }
+			inline bool operator!=(const welp::acc_buffer_ptr<Ty, _Allocator>::iterator& rhs) const noexcept { return internal_ptr != rhs.internal_ptr; }
+			inline bool operator<(const welp::acc_buffer_ptr<Ty, _Allocator>::iterator& rhs) const noexcept { return internal_ptr < rhs.internal_ptr; }
+			inline bool operator>(const welp::acc_buffer_ptr<Ty, _Allocator>::iterator& rhs) const noexcept { return internal_ptr > rhs.internal_ptr; }
+			inline bool operator<=(const welp::acc_buffer_ptr<Ty, _Allocator>::iterator& rhs) const noexcept { return internal_ptr <= rhs.internal_ptr; }
+			inline bool operator>=(const welp::acc_buffer_ptr<Ty, _Allocator>::iterator& rhs) const noexcept { return internal_ptr >= rhs.internal_ptr; }
+
+			iterator() = default;
+			iterator(Ty** ptr) : internal_ptr(ptr) {}
+			iterator(const welp::acc_buffer_ptr<Ty, _Allocator>::iterator&) = default;
+			welp::acc_buffer_ptr<Ty, _Allocator>::iterator& operator=(const welp::acc_buffer_ptr<Ty, _Allocator>::iterator&) = default;
+			iterator(welp::acc_buffer_ptr<Ty, _Allocator>::iterator&&) = default;
+			welp::acc_buffer_ptr<Ty, _Allocator>::iterator& operator=(welp::acc_buffer_ptr<Ty, _Allocator>::iterator&&) = default;
+			~iterator() = default;
+
+		private:
+
+			Ty** internal_ptr;
+		};
+
+	private:
+
+		Ty** current_ptr = nullptr;
+		Ty** data_ptr = nullptr;
+		std::size_t max_number_of_cells = 0;
+	};
+
 #ifdef WELP_ACC_BUFFER_INCLUDE_MUTEX
 	template <class Ty, class _Allocator = std::allocator<char>, class mutex_Ty = std::mutex> class acc_buffer_sync : private _Allocator
 	{
@@ -506,6 +658,26 @@ inline void welp::acc_buffer<Ty, _Allocator>::reset()
 	}
 }
 
+template <class Ty, class _Allocator> template <class pool_Ty, class function_Ty>
+void welp::acc_buffer<Ty, _Allocator>::for_each(pool_Ty& pool, function_Ty&& function, std::size_t grain)
+{
+	storage_cell* temp_data_ptr = data_ptr;
+	pool.parallel_for(static_cast<std::size_t>(0), static_cast<std::size_t>(current_ptr - data_ptr), grain,
+		[temp_data_ptr, &function](std::size_t n)
+		{
+			storage_cell* cell_ptr = temp_data_ptr + n;
+			if (cell_ptr->storage_ptr != nullptr) { function(*(cell_ptr->storage_ptr)); }
+			else { function(cell_ptr->storage); }
+		});
+}
+
+template <class Ty, class _Allocator> template <class pool_Ty, class value_Ty, class reduce_Ty, class transform_Ty>
+value_Ty welp::acc_buffer<Ty, _Allocator>::transform_reduce(pool_Ty& pool, value_Ty init, reduce_Ty&& reduce, transform_Ty&& transform)
+{
+	return pool.parallel_transform_reduce(begin(), end(), std::move(init),
+		std::forward<reduce_Ty>(reduce), std::forward<transform_Ty>(transform));
+}
+
 template <class Ty, class _Allocator>
 inline bool welp::acc_buffer<Ty, _Allocator>::new_buffer(std::size_t instances)
 {
@@ -609,6 +781,375 @@ welp::acc_buffer<Ty, _Allocator>::~acc_buffer()
 	delete_buffer();
 }
 
+template <class Ty, class _Allocator>
+inline welp::acc_buffer_raw<Ty, _Allocator>& welp::acc_buffer_raw<Ty, _Allocator>::operator<<(const Ty& obj)
+{
+#ifdef WELP_ACC_BUFFER_DEBUG_MODE
+	assert(current_ptr < data_ptr + max_number_of_cells);
+#endif // WELP_ACC_BUFFER_DEBUG_MODE
+	new (current_ptr) Ty(obj);
+	current_ptr++;
+	return *this;
+}
+
+template <class Ty, class _Allocator>
+inline welp::acc_buffer_raw<Ty, _Allocator>& welp::acc_buffer_raw<Ty, _Allocator>::operator<<(Ty&& obj) noexcept
+{
+#ifdef WELP_ACC_BUFFER_DEBUG_MODE
+	assert(current_ptr < data_ptr + max_number_of_cells);
+#endif // WELP_ACC_BUFFER_DEBUG_MODE
+	new (current_ptr) Ty(std::move(obj));
+	current_ptr++;
+	return *this;
+}
+
+template <class Ty, class _Allocator>
+inline welp::acc_buffer_raw<Ty, _Allocator>& welp::acc_buffer_raw<Ty, _Allocator>::operator<(const Ty& obj)
+{
+#ifdef WELP_ACC_BUFFER_DEBUG_MODE
+	assert(current_ptr < data_ptr + max_number_of_cells);
+#endif // WELP_ACC_BUFFER_DEBUG_MODE
+	new (current_ptr) Ty(obj);
+	current_ptr++;
+	return *this;
+}
+
+template <class Ty, class _Allocator>
+template <class ... _Args> inline welp::acc_buffer_raw<Ty, _Allocator>& welp::acc_buffer_raw<Ty, _Allocator>::emplace_back(_Args&& ... args)
+{
+#ifdef WELP_ACC_BUFFER_DEBUG_MODE
+	assert(current_ptr < data_ptr + max_number_of_cells);
+#endif // WELP_ACC_BUFFER_DEBUG_MODE
+	new (current_ptr) Ty(std::forward<_Args>(args)...);
+	current_ptr++;
+	return *this;
+}
+
+template <class Ty, class _Allocator>
+inline const Ty& welp::acc_buffer_raw<Ty, _Allocator>::operator[](std::size_t offset) const noexcept
+{
+#ifdef WELP_ACC_BUFFER_DEBUG_MODE
+	assert(data_ptr + offset < current_ptr);
+#endif // WELP_ACC_BUFFER_DEBUG_MODE
+	return *(data_ptr + offset);
+}
+
+template <class Ty, class _Allocator>
+inline Ty& welp::acc_buffer_raw<Ty, _Allocator>::operator[](std::size_t offset) noexcept
+{
+#ifdef WELP_ACC_BUFFER_DEBUG_MODE
+	assert(data_ptr + offset < current_ptr);
+#endif // WELP_ACC_BUFFER_DEBUG_MODE
+	return *(data_ptr + offset);
+}
+
+template <class Ty, class _Allocator>
+inline std::size_t welp::acc_buffer_raw<Ty, _Allocator>::size() const noexcept
+{
+	return static_cast<std::size_t>(current_ptr - data_ptr);
+}
+
+template <class Ty, class _Allocator>
+inline std::size_t welp::acc_buffer_raw<Ty, _Allocator>::capacity() const noexcept
+{
+	return max_number_of_cells;
+}
+
+template <class Ty, class _Allocator>
+inline void welp::acc_buffer_raw<Ty, _Allocator>::pop_back() noexcept
+{
+	if (current_ptr != data_ptr)
+	{
+		current_ptr--;
+		current_ptr->~Ty();
+	}
+}
+
+template <class Ty, class _Allocator>
+inline void welp::acc_buffer_raw<Ty, _Allocator>::pop_back(std::size_t instances) noexcept
+{
+	std::size_t n = static_cast<std::size_t>(current_ptr - data_ptr);
+	for (n = (instances < n) ? instances : n; n > 0; n--)
+	{
+		current_ptr--;
+		current_ptr->~Ty();
+	}
+}
+
+template <class Ty, class _Allocator>
+inline void welp::acc_buffer_raw<Ty, _Allocator>::reset() noexcept
+{
+	while (current_ptr != data_ptr)
+	{
+		current_ptr--;
+		current_ptr->~Ty();
+	}
+}
+
+// the storage is allocated with alignof(Ty) - 1 more bytes so that the first cell can be aligned
+template <class Ty, class _Allocator>
+bool welp::acc_buffer_raw<Ty, _Allocator>::new_buffer(std::size_t instances)
+{
+	delete_buffer();
+
+	raw_data_ptr = this->allocate(instances * sizeof(Ty) + alignof(Ty) - 1);
+	if (raw_data_ptr != nullptr)
+	{
+		std::size_t misalignment = static_cast<std::size_t>(reinterpret_cast<std::uintptr_t>(raw_data_ptr) % alignof(Ty));
+		data_ptr = static_cast<Ty*>(static_cast<void*>(raw_data_ptr + ((misalignment != 0) ? alignof(Ty) - misalignment : 0)));
+		current_ptr = data_ptr;
+		max_number_of_cells = instances;
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+template <class Ty, class _Allocator>
+void welp::acc_buffer_raw<Ty, _Allocator>::delete_buffer() noexcept
+{
+	if (raw_data_ptr != nullptr)
+	{
+		reset();
+		this->deallocate(raw_data_ptr, max_number_of_cells * sizeof(Ty) + alignof(Ty) - 1);
+		raw_data_ptr = nullptr;
+		current_ptr = nullptr;
+		data_ptr = nullptr;
+		max_number_of_cells = 0;
+	}
+}
+
+template <class Ty, class _Allocator>
+welp::acc_buffer_raw<Ty, _Allocator>::acc_buffer_raw(std::size_t instances)
+{
+	new_buffer(instances);
+}
+
+template <class Ty, class _Allocator>
+welp::acc_buffer_raw<Ty, _Allocator>::acc_buffer_raw(const welp::acc_buffer_raw<Ty, _Allocator>& rhs)
+	: _Allocator(rhs)
+{
+	if (new_buffer(rhs.capacity()))
+	{
+		for (const Ty* rhs_ptr = rhs.data_ptr; rhs_ptr != rhs.current_ptr; rhs_ptr++)
+		{
+			new (current_ptr) Ty(*rhs_ptr); current_ptr++;
+		}
+	}
+}
+
+template <class Ty, class _Allocator>
+welp::acc_buffer_raw<Ty, _Allocator>& welp::acc_buffer_raw<Ty, _Allocator>::operator=(const welp::acc_buffer_raw<Ty, _Allocator>& rhs)
+{
+	if (this != &rhs)
+	{
+		if (new_buffer(rhs.capacity()))
+		{
+			for (const Ty* rhs_ptr = rhs.data_ptr; rhs_ptr != rhs.current_ptr; rhs_ptr++)
+			{
+				new (current_ptr) Ty(*rhs_ptr); current_ptr++;
+			}
+		}
+	}
+	return *this;
+}
+
+template <class Ty, class _Allocator>
+welp::acc_buffer_raw<Ty, _Allocator>::acc_buffer_raw(welp::acc_buffer_raw<Ty, _Allocator>&& rhs) noexcept
+	: raw_data_ptr(rhs.raw_data_ptr), current_ptr(rhs.current_ptr), data_ptr(rhs.data_ptr), max_number_of_cells(rhs.max_number_of_cells)
+{
+	rhs.raw_data_ptr = nullptr;
+	rhs.current_ptr = nullptr;
+	rhs.data_ptr = nullptr;
+	rhs.max_number_of_cells = 0;
+}
+
+template <class Ty, class _Allocator>
+welp::acc_buffer_raw<Ty, _Allocator>& welp::acc_buffer_raw<Ty, _Allocator>::operator=(welp::acc_buffer_raw<Ty, _Allocator>&& rhs) noexcept
+{
+	if (this != &rhs)
+	{
+		delete_buffer();
+
+		raw_data_ptr = rhs.raw_data_ptr;
+		current_ptr = rhs.current_ptr;
+		data_ptr = rhs.data_ptr;
+		max_number_of_cells = rhs.max_number_of_cells;
+
+		rhs.raw_data_ptr = nullptr;
+		rhs.current_ptr = nullptr;
+		rhs.data_ptr = nullptr;
+		rhs.max_number_of_cells = 0;
+	}
+	return *this;
+}
+
+template <class Ty, class _Allocator>
+welp::acc_buffer_raw<Ty, _Allocator>::~acc_buffer_raw()
+{
+	delete_buffer();
+}
+
+template <class Ty, class _Allocator>
+inline welp::acc_buffer_ptr<Ty, _Allocator>& welp::acc_buffer_ptr<Ty, _Allocator>::operator<<(Ty* const obj_ptr) noexcept
+{
+#ifdef WELP_ACC_BUFFER_DEBUG_MODE
+	assert(current_ptr < data_ptr + max_number_of_cells);
+#endif // WELP_ACC_BUFFER_DEBUG_MODE
+	*current_ptr = obj_ptr;
+	current_ptr++;
+	return *this;
+}
+
+template <class Ty, class _Allocator>
+inline const Ty& welp::acc_buffer_ptr<Ty, _Allocator>::operator[](std::size_t offset) const noexcept
+{
+#ifdef WELP_ACC_BUFFER_DEBUG_MODE
+	assert(data_ptr + offset < current_ptr);
+#endif // WELP_ACC_BUFFER_DEBUG_MODE
+	return **(data_ptr + offset);
+}
+
+template <class Ty, class _Allocator>
+inline Ty& welp::acc_buffer_ptr<Ty, _Allocator>::operator[](std::size_t offset) noexcept
+{
+#ifdef WELP_ACC_BUFFER_DEBUG_MODE
+	assert(data_ptr + offset < current_ptr);
+#endif // WELP_ACC_BUFFER_DEBUG_MODE
+	return **(data_ptr + offset);
+}
+
+template <class Ty, class _Allocator>
+inline std::size_t welp::acc_buffer_ptr<Ty, _Allocator>::size() const noexcept
+{
+	return static_cast<std::size_t>(current_ptr - data_ptr);
+}
+
+template <class Ty, class _Allocator>
+inline std::size_t welp::acc_buffer_ptr<Ty, _Allocator>::capacity() const noexcept
+{
+	return max_number_of_cells;
+}
+
+template <class Ty, class _Allocator>
+inline void welp::acc_buffer_ptr<Ty, _Allocator>::pop_back() noexcept
+{
+	if (current_ptr != data_ptr) { current_ptr--; }
+}
+
+template <class Ty, class _Allocator>
+inline void welp::acc_buffer_ptr<Ty, _Allocator>::pop_back(std::size_t instances) noexcept
+{
+	std::size_t n = static_cast<std::size_t>(current_ptr - data_ptr);
+	current_ptr -= (instances < n) ? instances : n;
+}
+
+template <class Ty, class _Allocator>
+inline void welp::acc_buffer_ptr<Ty, _Allocator>::reset() noexcept
+{
+	current_ptr = data_ptr;
+}
+
+template <class Ty, class _Allocator>
+bool welp::acc_buffer_ptr<Ty, _Allocator>::new_buffer(std::size_t instances)
+{
+	delete_buffer();
+
+	data_ptr = static_cast<Ty**>(static_cast<void*>(this->allocate(instances * sizeof(Ty*))));
+	if (data_ptr != nullptr)
+	{
+		current_ptr = data_ptr;
+		max_number_of_cells = instances;
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+template <class Ty, class _Allocator>
+void welp::acc_buffer_ptr<Ty, _Allocator>::delete_buffer() noexcept
+{
+	if (data_ptr != nullptr)
+	{
+		this->deallocate(static_cast<char*>(static_cast<void*>(data_ptr)), max_number_of_cells * sizeof(Ty*));
+		current_ptr = nullptr;
+		data_ptr = nullptr;
+		max_number_of_cells = 0;
+	}
+}
+
+template <class Ty, class _Allocator>
+welp::acc_buffer_ptr<Ty, _Allocator>::acc_buffer_ptr(std::size_t instances)
+{
+	new_buffer(instances);
+}
+
+template <class Ty, class _Allocator>
+welp::acc_buffer_ptr<Ty, _Allocator>::acc_buffer_ptr(const welp::acc_buffer_ptr<Ty, _Allocator>& rhs)
+	: _Allocator(rhs)
+{
+	if (new_buffer(rhs.capacity()))
+	{
+		for (Ty** rhs_ptr = rhs.data_ptr; rhs_ptr != rhs.current_ptr; rhs_ptr++)
+		{
+			*current_ptr++ = *rhs_ptr;
+		}
+	}
+}
+
+template <class Ty, class _Allocator>
+welp::acc_buffer_ptr<Ty, _Allocator>& welp::acc_buffer_ptr<Ty, _Allocator>::operator=(const welp::acc_buffer_ptr<Ty, _Allocator>& rhs)
+{
+	if (this != &rhs)
+	{
+		if (new_buffer(rhs.capacity()))
+		{
+			for (Ty** rhs_ptr = rhs.data_ptr; rhs_ptr != rhs.current_ptr; rhs_ptr++)
+			{
+				*current_ptr++ = *rhs_ptr;
+			}
+		}
+	}
+	return *this;
+}
+
+template <class Ty, class _Allocator>
+welp::acc_buffer_ptr<Ty, _Allocator>::acc_buffer_ptr(welp::acc_buffer_ptr<Ty, _Allocator>&& rhs) noexcept
+	: current_ptr(rhs.current_ptr), data_ptr(rhs.data_ptr), max_number_of_cells(rhs.max_number_of_cells)
+{
+	rhs.current_ptr = nullptr;
+	rhs.data_ptr = nullptr;
+	rhs.max_number_of_cells = 0;
+}
+
+template <class Ty, class _Allocator>
+welp::acc_buffer_ptr<Ty, _Allocator>& welp::acc_buffer_ptr<Ty, _Allocator>::operator=(welp::acc_buffer_ptr<Ty, _Allocator>&& rhs) noexcept
+{
+	if (this != &rhs)
+	{
+		delete_buffer();
+
+		current_ptr = rhs.current_ptr;
+		data_ptr = rhs.data_ptr;
+		max_number_of_cells = rhs.max_number_of_cells;
+
+		rhs.current_ptr = nullptr;
+		rhs.data_ptr = nullptr;
+		rhs.max_number_of_cells = 0;
+	}
+	return *this;
+}
+
+template <class Ty, class _Allocator>
+welp::acc_buffer_ptr<Ty, _Allocator>::~acc_buffer_ptr()
+{
+	delete_buffer();
+}
+
 #ifdef WELP_ACC_BUFFER_INCLUDE_MUTEX
 template <class Ty, class _Allocator, class mutex_Ty>
 inline welp::acc_buffer_sync<Ty, _Allocator, mutex_Ty>& welp::acc_buffer_sync<Ty, _Allocator, mutex_Ty>::operator<<(const Ty& obj)
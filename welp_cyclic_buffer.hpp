@@ -9,6 +9,10 @@
 ////// INCLUDES //////
 
 #include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
 
 
 #if defined(WELP_CYCLIC_BUFFER_INCLUDE_ALL) || defined(WELP_ALWAYS_INCLUDE_ALL)
@@ -28,8 +32,11 @@
 
 #ifdef WELP_CYCLIC_BUFFER_INCLUDE_ATOMIC
 #ifndef WELP_CYCLIC_BUFFER_INCLUDE_MUTEX
+#include <mutex>
 #include <atomic>
 #endif // WELP_CYCLIC_BUFFER_INCLUDE_MUTEX
+#include <condition_variable>
+#include <type_traits>
 #endif // WELP_CYCLIC_BUFFER_INCLUDE_ATOMIC
 
 
@@ -49,6 +56,24 @@ namespace welp
 		inline void deallocate(char* ptr, std::size_t) const noexcept { std::free(static_cast<void*>(ptr)); }
 	};
 
+	// at most two contiguous runs of cells, the second one starts at the beginning of the buffer after the wrap point
+	template <class Ty> class cyclic_buffer_span
+	{
+
+	public:
+
+		Ty* first_ptr = nullptr;
+		std::size_t first_size = 0;
+		Ty* second_ptr = nullptr;
+		std::size_t second_size = 0;
+
+		inline std::size_t size() const noexcept { return first_size + second_size; }
+		inline Ty& operator[](std::size_t offset) const noexcept
+		{
+			return (offset < first_size) ? *(first_ptr + offset) : *(second_ptr + (offset - first_size));
+		}
+	};
+
 	template <class Ty, class _Allocator = default_cyclic_buffer_allocator> class cyclic_buffer : private _Allocator
 	{
 
@@ -62,8 +87,11 @@ namespace welp
 		inline bool store_move(Ty&& obj) noexcept;
 		inline bool store_ptr(Ty* obj) noexcept;
 
+		inline std::size_t store_n(const Ty* obj_ptr, std::size_t n);
+
 		inline bool load_cpy(Ty& obj);
 		inline bool load(Ty& obj) noexcept;
+		inline std::size_t load_n(Ty* obj_ptr, std::size_t n) noexcept;
 
 		inline std::size_t size() const noexcept;
 		inline std::size_t capacity() const noexcept;
@@ -107,6 +135,115 @@ namespace welp
 		};
 	};
 
+	// objects are constructed in place when stored and destroyed when loaded, the cells are uninitialised storage otherwise,
+	// there is no by-pointer mode, a cyclic_buffer_raw<Ty*> can be used for that
+	template <class Ty, class _Allocator = default_cyclic_buffer_allocator> class cyclic_buffer_raw : private _Allocator
+	{
+
+	public:
+
+		inline bool store_cpy(const Ty& obj);
+		inline bool store_move(Ty&& obj) noexcept;
+		template <class ... _Args> inline bool store_emplace(_Args&& ... args);
+		inline std::size_t store_n(const Ty* obj_ptr, std::size_t n);
+
+		inline bool load(Ty& obj) noexcept;
+		inline std::size_t load_n(Ty* obj_ptr, std::size_t n) noexcept;
+
+		inline std::size_t size() const noexcept;
+		inline std::size_t capacity() const noexcept;
+		inline std::size_t capacity_remaining() const noexcept;
+
+		bool new_buffer(std::size_t instances);
+		void delete_buffer() noexcept;
+
+		cyclic_buffer_raw() = default;
+		cyclic_buffer_raw(const welp::cyclic_buffer_raw<Ty, _Allocator>&) = delete;
+		welp::cyclic_buffer_raw<Ty, _Allocator>& operator=(const welp::cyclic_buffer_raw<Ty, _Allocator>&) = delete;
+		cyclic_buffer_raw(welp::cyclic_buffer_raw<Ty, _Allocator>&&) = delete;
+		welp::cyclic_buffer_raw<Ty, _Allocator>& operator=(welp::cyclic_buffer_raw<Ty, _Allocator>&&) = delete;
+		~cyclic_buffer_raw() { delete_buffer(); }
+
+	private:
+
+		char* raw_data_ptr = nullptr;
+		Ty* cells_data_ptr = nullptr;
+		Ty* cells_end_ptr = nullptr;
+
+		Ty* last_cell_ptr = nullptr;
+		Ty* next_cell_ptr = nullptr;
+
+		std::size_t _size = 0;
+		std::size_t _capacity = 0;
+	};
+
+	// linked chunks of chunk_size cells taken from _Allocator as the buffer grows, drained chunks go back to a cache
+	// of at most as many chunks as new_buffer has reserved, stores only fail if a chunk cannot be allocated
+	template <class Ty, class _Allocator = default_cyclic_buffer_allocator,
+		std::size_t chunk_size = 256> class cyclic_buffer_seg : private _Allocator
+	{
+
+	private:
+
+		class chunk;
+
+	public:
+
+		inline bool store_cpy(const Ty& obj);
+		inline bool store_move(Ty&& obj);
+		template <class ... _Args> inline bool store_emplace(_Args&& ... args);
+
+		inline bool load(Ty& obj) noexcept;
+
+		inline std::size_t size() const noexcept;
+		inline std::size_t capacity() const noexcept;
+		inline std::size_t chunk_count() const noexcept;
+
+		// reserves enough chunks in the cache for instances objects
+		bool new_buffer(std::size_t instances);
+		void delete_buffer() noexcept;
+
+		cyclic_buffer_seg() = default;
+		cyclic_buffer_seg(const welp::cyclic_buffer_seg<Ty, _Allocator, chunk_size>&) = delete;
+		welp::cyclic_buffer_seg<Ty, _Allocator, chunk_size>& operator=(const welp::cyclic_buffer_seg<Ty, _Allocator, chunk_size>&) = delete;
+		cyclic_buffer_seg(welp::cyclic_buffer_seg<Ty, _Allocator, chunk_size>&&) = delete;
+		welp::cyclic_buffer_seg<Ty, _Allocator, chunk_size>& operator=(welp::cyclic_buffer_seg<Ty, _Allocator, chunk_size>&&) = delete;
+		~cyclic_buffer_seg() { delete_buffer(); }
+
+	private:
+
+		chunk* head_chunk_ptr = nullptr;
+		chunk* tail_chunk_ptr = nullptr;
+		chunk* cached_chunk_ptr = nullptr;
+
+		Ty* next_cell_ptr = nullptr;
+		Ty* head_end_ptr = nullptr;
+		Ty* last_cell_ptr = nullptr;
+		Ty* tail_end_ptr = nullptr;
+
+		std::size_t _size = 0;
+		std::size_t chunks = 0;
+		std::size_t cached_chunks = 0;
+		std::size_t max_cached_chunks = 0;
+
+		static constexpr std::size_t chunk_bytes = sizeof(chunk) + alignof(Ty) - 1 + chunk_size * sizeof(Ty);
+
+		inline bool push_chunk_sub();
+		inline void pop_chunk_sub() noexcept;
+		inline chunk* allocate_chunk_sub();
+		inline chunk* new_chunk_sub();
+		inline void release_chunk_sub(chunk* chunk_ptr) noexcept;
+
+		class chunk
+		{
+
+		public:
+
+			chunk* next_chunk_ptr = nullptr;
+			Ty* cells_data_ptr = nullptr;
+		};
+	};
+
 #ifdef WELP_CYCLIC_BUFFER_INCLUDE_ATOMIC
 	template <class Ty, class _Allocator = default_cyclic_buffer_allocator,
 		std::size_t padding_size = 8> class cyclic_buffer_atom : private _Allocator
@@ -170,6 +307,342 @@ namespace welp
 			~storage_cell() = default;
 		};
 	};
+
+	// one thread storing and one thread loading only, each index is written by one side and read with acquire loads by the other,
+	// each side keeps a copy of the index of the other side and only reloads it when the buffer looks full or empty
+	template <class Ty, class _Allocator = default_cyclic_buffer_allocator,
+		std::size_t padding_size = 8> class cyclic_buffer_spsc : private _Allocator
+	{
+
+	public:
+
+		inline bool store_cpy(const Ty& obj);
+		inline bool store_move(Ty&& obj) noexcept;
+		inline std::size_t store_n(const Ty* obj_ptr, std::size_t n);
+
+		// cells to write into in place, visible to the loading thread after commit_write
+		inline welp::cyclic_buffer_span<Ty> reserve_write(std::size_t n) noexcept;
+		inline void commit_write(std::size_t n) noexcept;
+
+		inline bool load(Ty& obj) noexcept;
+		inline std::size_t load_n(Ty* obj_ptr, std::size_t n) noexcept;
+
+		inline std::size_t size() const noexcept;
+		inline std::size_t capacity() const noexcept;
+		inline std::size_t capacity_remaining() const noexcept;
+
+		bool new_buffer(std::size_t instances);
+		void delete_buffer() noexcept;
+
+		cyclic_buffer_spsc() = default;
+		cyclic_buffer_spsc(const welp::cyclic_buffer_spsc<Ty, _Allocator, padding_size>&) = delete;
+		welp::cyclic_buffer_spsc<Ty, _Allocator, padding_size>& operator=(const welp::cyclic_buffer_spsc<Ty, _Allocator, padding_size>&) = delete;
+		cyclic_buffer_spsc(welp::cyclic_buffer_spsc<Ty, _Allocator, padding_size>&&) = delete;
+		welp::cyclic_buffer_spsc<Ty, _Allocator, padding_size>& operator=(welp::cyclic_buffer_spsc<Ty, _Allocator, padding_size>&&) = delete;
+		~cyclic_buffer_spsc() { delete_buffer(); }
+
+	private:
+
+		Ty* cells_data_ptr = nullptr;
+		std::size_t cell_count = 0;
+		std::size_t _capacity = 0;
+
+		// written by the storing thread
+		std::size_t padding0[padding_size] = { 0 };
+		std::atomic<std::size_t> last_cell_index{ 0 };
+		std::size_t cached_next_cell_index = 1; // 1 without buffer so that a store goes through the slow path and fails
+
+		// written by the loading thread
+		std::size_t padding1[padding_size] = { 0 };
+		std::atomic<std::size_t> next_cell_index{ 0 };
+		std::size_t cached_last_cell_index = 0;
+		std::size_t padding2[padding_size] = { 0 };
+
+		inline bool store_sub(std::size_t& temp_last_cell_index, std::size_t& final_last_cell_index) noexcept;
+		inline std::size_t store_n_sub(std::size_t temp_last_cell_index, std::size_t n) noexcept;
+	};
+
+	// many threads storing and many threads loading, each cell carries a sequence number telling whether it is free to store into
+	// or ready to load from, so that threads only contend on the index of their own side and never on the cells of the other side
+	template <class Ty, class _Allocator = default_cyclic_buffer_allocator,
+		std::size_t padding_size = 8> class cyclic_buffer_mpmc : private _Allocator
+	{
+
+	private:
+
+		class storage_cell;
+
+	public:
+
+		inline bool store_cpy(const Ty& obj);
+		inline bool store_move(Ty&& obj) noexcept;
+
+		// wait until a cell is free, return false only if there is no buffer
+		inline bool store_wait(const Ty& obj);
+		inline bool store_wait(Ty&& obj);
+
+		inline bool load(Ty& obj) noexcept;
+
+		// wait until a cell is ready, return false only if there is no buffer
+		inline bool load_wait(Ty& obj);
+
+		inline std::size_t size() const noexcept;
+		inline std::size_t capacity() const noexcept;
+		inline std::size_t capacity_remaining() const noexcept;
+
+		// the capacity is rounded up to a power of two
+		bool new_buffer(std::size_t instances);
+		void delete_buffer() noexcept;
+
+		cyclic_buffer_mpmc() = default;
+		cyclic_buffer_mpmc(const welp::cyclic_buffer_mpmc<Ty, _Allocator, padding_size>&) = delete;
+		welp::cyclic_buffer_mpmc<Ty, _Allocator, padding_size>& operator=(const welp::cyclic_buffer_mpmc<Ty, _Allocator, padding_size>&) = delete;
+		cyclic_buffer_mpmc(welp::cyclic_buffer_mpmc<Ty, _Allocator, padding_size>&&) = delete;
+		welp::cyclic_buffer_mpmc<Ty, _Allocator, padding_size>& operator=(welp::cyclic_buffer_mpmc<Ty, _Allocator, padding_size>&&) = delete;
+		~cyclic_buffer_mpmc() { delete_buffer(); }
+
+	private:
+
+		storage_cell* cells_data_ptr = nullptr;
+		std::size_t cell_mask = 0;
+		std::size_t _capacity = 0;
+
+		std::size_t padding0[padding_size] = { 0 };
+		std::atomic<std::size_t> last_cell_index{ 0 };
+		std::size_t padding1[padding_size] = { 0 };
+		std::atomic<std::size_t> next_cell_index{ 0 };
+		std::size_t padding2[padding_size] = { 0 };
+
+		// only touched by the waiting functions or when a thread is parked
+		std::atomic<std::size_t> store_waiters{ 0 };
+		std::atomic<std::size_t> load_waiters{ 0 };
+		std::mutex wait_mutex;
+		std::condition_variable store_condition_var;
+		std::condition_variable load_condition_var;
+
+		inline storage_cell* store_sub(std::size_t& temp_last_cell_index) noexcept;
+		inline storage_cell* load_sub(std::size_t& temp_next_cell_index) noexcept;
+		inline void notify_store_sub();
+		inline void notify_load_sub();
+
+		class storage_cell
+		{
+
+		public:
+
+			std::atomic<std::size_t> sequence{ 0 };
+			Ty storage = Ty();
+
+			storage_cell() = default;
+			storage_cell(const welp::cyclic_buffer_mpmc<Ty, _Allocator, padding_size>::storage_cell&) = delete;
+			welp::cyclic_buffer_mpmc<Ty, _Allocator, padding_size>::storage_cell& operator=(
+				const welp::cyclic_buffer_mpmc<Ty, _Allocator, padding_size>::storage_cell&) = delete;
+			storage_cell(welp::cyclic_buffer_mpmc<Ty, _Allocator, padding_size>::storage_cell&&) = delete;
+			welp::cyclic_buffer_mpmc<Ty, _Allocator, padding_size>::storage_cell& operator=(
+				welp::cyclic_buffer_mpmc<Ty, _Allocator, padding_size>::storage_cell&&) = delete;
+			~storage_cell() = default;
+		};
+	};
+
+	// one thread storing, a full buffer overwrites its oldest object instead of rejecting the store,
+	// any thread can copy out the most recent objects with snapshot and one thread can load them,
+	// the readers copy first and then check which of the copied objects the writer may have overwritten meanwhile,
+	// so the writer never waits and Ty must be trivially copyable
+	template <class Ty, class _Allocator = default_cyclic_buffer_allocator,
+		std::size_t padding_size = 8> class cyclic_buffer_lossy : private _Allocator
+	{
+
+	public:
+
+		static_assert(std::is_trivially_copyable<Ty>::value, "welp::cyclic_buffer_lossy requires a trivially copyable type");
+
+		// return false only if there is no buffer
+		inline bool store_cpy(const Ty& obj) noexcept;
+		inline bool store_move(Ty&& obj) noexcept;
+
+		// one thread loading only
+		inline bool load(Ty& obj) noexcept;
+
+		// copies up to n of the most recent objects in obj_ptr, oldest first, and returns how many were copied
+		inline std::size_t snapshot(Ty* obj_ptr, std::size_t n) const noexcept;
+
+		// objects overwritten before being loaded
+		inline std::size_t dropped() const noexcept;
+		inline std::size_t size() const noexcept;
+		inline std::size_t capacity() const noexcept;
+
+		bool new_buffer(std::size_t instances);
+		void delete_buffer() noexcept;
+
+		cyclic_buffer_lossy() = default;
+		cyclic_buffer_lossy(const welp::cyclic_buffer_lossy<Ty, _Allocator, padding_size>&) = delete;
+		welp::cyclic_buffer_lossy<Ty, _Allocator, padding_size>& operator=(const welp::cyclic_buffer_lossy<Ty, _Allocator, padding_size>&) = delete;
+		cyclic_buffer_lossy(welp::cyclic_buffer_lossy<Ty, _Allocator, padding_size>&&) = delete;
+		welp::cyclic_buffer_lossy<Ty, _Allocator, padding_size>& operator=(welp::cyclic_buffer_lossy<Ty, _Allocator, padding_size>&&) = delete;
+		~cyclic_buffer_lossy() { delete_buffer(); }
+
+	private:
+
+		Ty* cells_data_ptr = nullptr;
+		Ty* cells_end_ptr = nullptr;
+		std::size_t _capacity = 0;
+
+		// written by the storing thread, writing_index is incremented before a cell is written and written_index after
+		std::size_t padding0[padding_size] = { 0 };
+		std::atomic<std::size_t> writing_index{ 0 };
+		std::atomic<std::size_t> written_index{ 0 };
+		Ty* last_cell_ptr = nullptr;
+
+		// written by the loading thread
+		std::size_t padding1[padding_size] = { 0 };
+		std::atomic<std::size_t> next_index{ 0 };
+		std::atomic<std::size_t> skipped{ 0 };
+		std::size_t padding2[padding_size] = { 0 };
+
+		inline std::size_t first_valid_index_sub() const noexcept;
+	};
+
+	// cells and indices placed in a region provided by the caller, for instance shared memory mapped by several processes,
+	// the region only holds indices and offsets so that each process can map it at a different address,
+	// the cells follow the same sequence number protocol as cyclic_buffer_mpmc
+	template <class Ty, std::size_t padding_size = 8> class cyclic_buffer_shm
+	{
+
+	private:
+
+		class shared_header;
+		class storage_cell;
+
+	public:
+
+		static_assert(std::is_trivially_copyable<Ty>::value, "welp::cyclic_buffer_shm requires a trivially copyable type");
+
+		// the capacity is rounded up to a power of two
+		static std::size_t required_bytes(std::size_t instances) noexcept;
+
+		// create initialises the region, attach uses a region initialised by create, possibly in another process,
+		// both return false if the region is too small, misaligned, or if std::atomic<std::size_t> is not lock-free
+		bool create(void* region_ptr, std::size_t region_bytes, std::size_t instances) noexcept;
+		bool attach(void* region_ptr, std::size_t region_bytes) noexcept;
+		void detach() noexcept;
+
+		inline bool store_cpy(const Ty& obj) noexcept;
+		inline bool load(Ty& obj) noexcept;
+
+		inline std::size_t size() const noexcept;
+		inline std::size_t capacity() const noexcept;
+		inline std::size_t capacity_remaining() const noexcept;
+
+		cyclic_buffer_shm() = default;
+		cyclic_buffer_shm(const welp::cyclic_buffer_shm<Ty, padding_size>&) = delete;
+		welp::cyclic_buffer_shm<Ty, padding_size>& operator=(const welp::cyclic_buffer_shm<Ty, padding_size>&) = delete;
+		cyclic_buffer_shm(welp::cyclic_buffer_shm<Ty, padding_size>&&) = delete;
+		welp::cyclic_buffer_shm<Ty, padding_size>& operator=(welp::cyclic_buffer_shm<Ty, padding_size>&&) = delete;
+		~cyclic_buffer_shm() = default;
+
+	private:
+
+		// process local
+		shared_header* header_ptr = nullptr;
+		storage_cell* cells_data_ptr = nullptr;
+		std::size_t cell_mask = 0;
+
+		static constexpr std::size_t layout_tag = 0x77656c70u;
+
+		static std::size_t cells_offset_sub() noexcept;
+		static std::size_t cell_count_sub(std::size_t instances) noexcept;
+		static bool region_check_sub(void* region_ptr, std::size_t region_bytes) noexcept;
+
+		class shared_header
+		{
+
+		public:
+
+			std::atomic<std::size_t> ready{ 0 };
+			std::size_t cell_count = 0;
+			std::size_t cell_bytes = 0;
+			std::size_t cells_offset = 0;
+
+			std::size_t padding0[padding_size] = { 0 };
+			std::atomic<std::size_t> last_cell_index{ 0 };
+			std::size_t padding1[padding_size] = { 0 };
+			std::atomic<std::size_t> next_cell_index{ 0 };
+			std::size_t padding2[padding_size] = { 0 };
+		};
+
+		class storage_cell
+		{
+
+		public:
+
+			std::atomic<std::size_t> sequence{ 0 };
+			Ty storage;
+		};
+	};
+
+	// one thread storing and a fixed number of readers that each see every object, the objects are written once
+	// and read in place, the writer only stores into a cell once every reader has released it
+	template <class Ty, class _Allocator = default_cyclic_buffer_allocator,
+		std::size_t padding_size = 8> class cyclic_buffer_broadcast : private _Allocator
+	{
+
+	private:
+
+		class reader_cursor;
+
+	public:
+
+		// one thread storing only, return false if the slowest reader has not released enough cells
+		inline bool store_cpy(const Ty& obj);
+		inline bool store_move(Ty&& obj) noexcept;
+
+		// one thread per reader number, read gives access to up to n objects not yet released by the reader
+		inline welp::cyclic_buffer_span<const Ty> read(std::size_t reader, std::size_t n) noexcept;
+		inline void release(std::size_t reader, std::size_t n) noexcept;
+		inline bool load(std::size_t reader, Ty& obj);
+
+		inline std::size_t size(std::size_t reader) const noexcept;
+		inline std::size_t capacity() const noexcept;
+		inline std::size_t number_of_readers() const noexcept;
+
+		// the capacity is rounded up to a power of two
+		bool new_buffer(std::size_t instances, std::size_t readers);
+		void delete_buffer() noexcept;
+
+		cyclic_buffer_broadcast() = default;
+		cyclic_buffer_broadcast(const welp::cyclic_buffer_broadcast<Ty, _Allocator, padding_size>&) = delete;
+		welp::cyclic_buffer_broadcast<Ty, _Allocator, padding_size>& operator=(const welp::cyclic_buffer_broadcast<Ty, _Allocator, padding_size>&) = delete;
+		cyclic_buffer_broadcast(welp::cyclic_buffer_broadcast<Ty, _Allocator, padding_size>&&) = delete;
+		welp::cyclic_buffer_broadcast<Ty, _Allocator, padding_size>& operator=(welp::cyclic_buffer_broadcast<Ty, _Allocator, padding_size>&&) = delete;
+		~cyclic_buffer_broadcast() { delete_buffer(); }
+
+	private:
+
+		Ty* cells_data_ptr = nullptr;
+		std::size_t cell_count = 0; // cells allocated, _capacity counts the cells constructed
+		std::size_t cell_mask = 0;
+		std::size_t _capacity = 0;
+		reader_cursor* readers_data_ptr = nullptr;
+		std::size_t _readers = 0;
+
+		// written by the storing thread, cached_min_index is the lowest reader cursor seen by the writer
+		std::size_t padding0[padding_size] = { 0 };
+		std::atomic<std::size_t> written_index{ 0 };
+		std::size_t cached_min_index = 0;
+		std::size_t padding1[padding_size] = { 0 };
+
+		inline bool store_sub(std::size_t temp_index) noexcept;
+
+		class reader_cursor
+		{
+
+		public:
+
+			std::atomic<std::size_t> next_index{ 0 };
+			std::size_t cached_written_index = 0;
+			std::size_t padding[padding_size] = { 0 };
+		};
+	};
 #endif // WELP_CYCLIC_BUFFER_INCLUDE_ATOMIC
 
 #ifdef WELP_CYCLIC_BUFFER_INCLUDE_MUTEX
@@ -186,8 +659,11 @@ namespace welp
 		inline bool store_move(Ty&& obj) noexcept;
 		inline bool store_ptr(Ty* obj_ptr) noexcept;
 
+		inline std::size_t store_n(const Ty* obj_ptr, std::size_t n);
+
 		inline bool load_cpy(Ty& obj);
 		inline bool load(Ty& obj) noexcept;
+		inline std::size_t load_n(Ty* obj_ptr, std::size_t n) noexcept;
 
 		inline std::size_t size() const noexcept;
 		inline std::size_t capacity() const noexcept;
@@ -458,6 +934,27 @@ inline bool welp::cyclic_buffer<Ty, _Allocator>::store_ptr(Ty* obj_ptr) noexcept
 	}
 }
 
+template <class Ty, class _Allocator>
+inline std::size_t welp::cyclic_buffer<Ty, _Allocator>::store_n(const Ty* obj_ptr, std::size_t n)
+{
+	if (n > _capacity - _size) { n = _capacity - _size; }
+	storage_cell* temp_cell_ptr = last_cell_ptr;
+	std::size_t k = 0;
+	while (k < n)
+	{
+		std::size_t segment_n = static_cast<std::size_t>(cells_end_ptr - temp_cell_ptr);
+		if (segment_n > n - k) { segment_n = n - k; }
+		for (storage_cell* const segment_end_ptr = temp_cell_ptr + segment_n; temp_cell_ptr != segment_end_ptr; temp_cell_ptr++)
+		{
+			temp_cell_ptr->storage = *(obj_ptr + k); k++;
+		}
+		if (temp_cell_ptr == cells_end_ptr) { temp_cell_ptr = cells_data_ptr; }
+	}
+	last_cell_ptr = temp_cell_ptr;
+	_size += n;
+	return n;
+}
+
 template <class Ty, class _Allocator>
 inline bool welp::cyclic_buffer<Ty, _Allocator>::load_cpy(Ty& obj)
 {
@@ -516,6 +1013,37 @@ inline bool welp::cyclic_buffer<Ty, _Allocator>::load(Ty& obj) noexcept
 	}
 }
 
+template <class Ty, class _Allocator>
+inline std::size_t welp::cyclic_buffer<Ty, _Allocator>::load_n(Ty* obj_ptr, std::size_t n) noexcept
+{
+	if (n > _size) { n = _size; }
+	storage_cell* temp_cell_ptr = next_cell_ptr;
+	std::size_t k = 0;
+	while (k < n)
+	{
+		std::size_t segment_n = static_cast<std::size_t>(cells_end_ptr - temp_cell_ptr);
+		if (segment_n > n - k) { segment_n = n - k; }
+		for (storage_cell* const segment_end_ptr = temp_cell_ptr + segment_n; temp_cell_ptr != segment_end_ptr; temp_cell_ptr++)
+		{
+			if (temp_cell_ptr->storage_ptr == nullptr)
+			{
+				*(obj_ptr + k) = std::move(temp_cell_ptr->storage);
+			}
+			else
+			{
+				const Ty* temp_storage_ptr = temp_cell_ptr->storage_ptr;
+				temp_cell_ptr->storage_ptr = nullptr;
+				*(obj_ptr + k) = std::move(*temp_storage_ptr);
+			}
+			k++;
+		}
+		if (temp_cell_ptr == cells_end_ptr) { temp_cell_ptr = cells_data_ptr; }
+	}
+	next_cell_ptr = temp_cell_ptr;
+	_size -= n;
+	return n;
+}
+
 template <class Ty, class _Allocator>
 inline std::size_t welp::cyclic_buffer<Ty, _Allocator>::size() const noexcept
 {
@@ -587,6 +1115,423 @@ void welp::cyclic_buffer<Ty, _Allocator>::delete_buffer() noexcept
 	}
 }
 
+template <class Ty, class _Allocator>
+inline bool welp::cyclic_buffer_raw<Ty, _Allocator>::store_cpy(const Ty& obj)
+{
+	if (_size != _capacity)
+	{
+		new (last_cell_ptr) Ty(obj);
+		last_cell_ptr++;
+		if (last_cell_ptr == cells_end_ptr) { last_cell_ptr = cells_data_ptr; }
+		_size++;
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+template <class Ty, class _Allocator>
+inline bool welp::cyclic_buffer_raw<Ty, _Allocator>::store_move(Ty&& obj) noexcept
+{
+	if (_size != _capacity)
+	{
+		new (last_cell_ptr) Ty(std::move(obj));
+		last_cell_ptr++;
+		if (last_cell_ptr == cells_end_ptr) { last_cell_ptr = cells_data_ptr; }
+		_size++;
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+template <class Ty, class _Allocator>
+template <class ... _Args> inline bool welp::cyclic_buffer_raw<Ty, _Allocator>::store_emplace(_Args&& ... args)
+{
+	if (_size != _capacity)
+	{
+		new (last_cell_ptr) Ty(std::forward<_Args>(args)...);
+		last_cell_ptr++;
+		if (last_cell_ptr == cells_end_ptr) { last_cell_ptr = cells_data_ptr; }
+		_size++;
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+// if a copy throws, the objects copied so far stay stored
+template <class Ty, class _Allocator>
+inline std::size_t welp::cyclic_buffer_raw<Ty, _Allocator>::store_n(const Ty* obj_ptr, std::size_t n)
+{
+	if (n > _capacity - _size) { n = _capacity - _size; }
+	Ty* temp_cell_ptr = last_cell_ptr;
+	std::size_t k = 0;
+	try
+	{
+		while (k < n)
+		{
+			std::size_t segment_n = static_cast<std::size_t>(cells_end_ptr - temp_cell_ptr);
+			if (segment_n > n - k) { segment_n = n - k; }
+			for (Ty* const segment_end_ptr = temp_cell_ptr + segment_n; temp_cell_ptr != segment_end_ptr; temp_cell_ptr++)
+			{
+				new (temp_cell_ptr) Ty(*(obj_ptr + k)); k++;
+			}
+			if (temp_cell_ptr == cells_end_ptr) { temp_cell_ptr = cells_data_ptr; }
+		}
+	}
+	catch (...)
+	{
+		last_cell_ptr = temp_cell_ptr;
+		_size += k;
+		throw;
+	}
+	last_cell_ptr = temp_cell_ptr;
+	_size += n;
+	return n;
+}
+
+template <class Ty, class _Allocator>
+inline bool welp::cyclic_buffer_raw<Ty, _Allocator>::load(Ty& obj) noexcept
+{
+	if (_size != 0)
+	{
+		obj = std::move(*next_cell_ptr);
+		next_cell_ptr->~Ty();
+		next_cell_ptr++;
+		if (next_cell_ptr == cells_end_ptr) { next_cell_ptr = cells_data_ptr; }
+		_size--;
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+template <class Ty, class _Allocator>
+inline std::size_t welp::cyclic_buffer_raw<Ty, _Allocator>::load_n(Ty* obj_ptr, std::size_t n) noexcept
+{
+	if (n > _size) { n = _size; }
+	Ty* temp_cell_ptr = next_cell_ptr;
+	std::size_t k = 0;
+	while (k < n)
+	{
+		std::size_t segment_n = static_cast<std::size_t>(cells_end_ptr - temp_cell_ptr);
+		if (segment_n > n - k) { segment_n = n - k; }
+		for (Ty* const segment_end_ptr = temp_cell_ptr + segment_n; temp_cell_ptr != segment_end_ptr; temp_cell_ptr++)
+		{
+			*(obj_ptr + k) = std::move(*temp_cell_ptr);
+			temp_cell_ptr->~Ty(); k++;
+		}
+		if (temp_cell_ptr == cells_end_ptr) { temp_cell_ptr = cells_data_ptr; }
+	}
+	next_cell_ptr = temp_cell_ptr;
+	_size -= n;
+	return n;
+}
+
+template <class Ty, class _Allocator>
+inline std::size_t welp::cyclic_buffer_raw<Ty, _Allocator>::size() const noexcept
+{
+	return _size;
+}
+
+template <class Ty, class _Allocator>
+inline std::size_t welp::cyclic_buffer_raw<Ty, _Allocator>::capacity() const noexcept
+{
+	return _capacity;
+}
+
+template <class Ty, class _Allocator>
+inline std::size_t welp::cyclic_buffer_raw<Ty, _Allocator>::capacity_remaining() const noexcept
+{
+	return _capacity - _size;
+}
+
+// the storage is allocated with alignof(Ty) - 1 more bytes so that the first cell can be aligned,
+// no cell is kept empty since _size tells a full buffer from an empty one
+template <class Ty, class _Allocator>
+bool welp::cyclic_buffer_raw<Ty, _Allocator>::new_buffer(std::size_t instances)
+{
+	delete_buffer();
+
+	raw_data_ptr = this->allocate(instances * sizeof(Ty) + alignof(Ty) - 1);
+	if (raw_data_ptr != nullptr)
+	{
+		std::size_t misalignment = static_cast<std::size_t>(reinterpret_cast<std::uintptr_t>(raw_data_ptr) % alignof(Ty));
+		cells_data_ptr = static_cast<Ty*>(static_cast<void*>(raw_data_ptr + ((misalignment != 0) ? alignof(Ty) - misalignment : 0)));
+		cells_end_ptr = cells_data_ptr + instances;
+		next_cell_ptr = cells_data_ptr;
+		last_cell_ptr = cells_data_ptr;
+		_capacity = instances;
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+template <class Ty, class _Allocator>
+void welp::cyclic_buffer_raw<Ty, _Allocator>::delete_buffer() noexcept
+{
+	if (raw_data_ptr != nullptr)
+	{
+		for (; _size > 0; _size--)
+		{
+			next_cell_ptr->~Ty();
+			next_cell_ptr++;
+			if (next_cell_ptr == cells_end_ptr) { next_cell_ptr = cells_data_ptr; }
+		}
+		this->deallocate(raw_data_ptr, _capacity * sizeof(Ty) + alignof(Ty) - 1);
+		raw_data_ptr = nullptr;
+		cells_data_ptr = nullptr;
+		cells_end_ptr = nullptr;
+		next_cell_ptr = nullptr;
+		last_cell_ptr = nullptr;
+		_capacity = 0;
+	}
+}
+
+template <class Ty, class _Allocator, std::size_t chunk_size>
+constexpr std::size_t welp::cyclic_buffer_seg<Ty, _Allocator, chunk_size>::chunk_bytes;
+
+// the cells are aligned after the chunk header
+template <class Ty, class _Allocator, std::size_t chunk_size>
+inline typename welp::cyclic_buffer_seg<Ty, _Allocator, chunk_size>::chunk* welp::cyclic_buffer_seg<Ty, _Allocator, chunk_size>::allocate_chunk_sub()
+{
+	char* raw_ptr = this->allocate(chunk_bytes);
+	if (raw_ptr == nullptr) { return nullptr; }
+	chunk* temp_chunk_ptr = new (raw_ptr) chunk();
+	char* cells_ptr = raw_ptr + sizeof(chunk);
+	std::size_t misalignment = static_cast<std::size_t>(reinterpret_cast<std::uintptr_t>(cells_ptr) % alignof(Ty));
+	temp_chunk_ptr->cells_data_ptr = static_cast<Ty*>(static_cast<void*>(cells_ptr + ((misalignment != 0) ? alignof(Ty) - misalignment : 0)));
+	chunks++;
+	return temp_chunk_ptr;
+}
+
+// takes a chunk from the cache, or from _Allocator if the cache is empty
+template <class Ty, class _Allocator, std::size_t chunk_size>
+inline typename welp::cyclic_buffer_seg<Ty, _Allocator, chunk_size>::chunk* welp::cyclic_buffer_seg<Ty, _Allocator, chunk_size>::new_chunk_sub()
+{
+	chunk* temp_chunk_ptr = cached_chunk_ptr;
+	if (temp_chunk_ptr != nullptr)
+	{
+		cached_chunk_ptr = temp_chunk_ptr->next_chunk_ptr;
+		cached_chunks--;
+		temp_chunk_ptr->next_chunk_ptr = nullptr;
+		return temp_chunk_ptr;
+	}
+	else
+	{
+		return allocate_chunk_sub();
+	}
+}
+
+template <class Ty, class _Allocator, std::size_t chunk_size>
+inline void welp::cyclic_buffer_seg<Ty, _Allocator, chunk_size>::release_chunk_sub(chunk* chunk_ptr) noexcept
+{
+	if (cached_chunks < max_cached_chunks)
+	{
+		chunk_ptr->next_chunk_ptr = cached_chunk_ptr;
+		cached_chunk_ptr = chunk_ptr;
+		cached_chunks++;
+	}
+	else
+	{
+		chunk_ptr->~chunk();
+		this->deallocate(static_cast<char*>(static_cast<void*>(chunk_ptr)), chunk_bytes);
+		chunks--;
+	}
+}
+
+// links a new chunk after the full tail chunk
+template <class Ty, class _Allocator, std::size_t chunk_size>
+inline bool welp::cyclic_buffer_seg<Ty, _Allocator, chunk_size>::push_chunk_sub()
+{
+	chunk* temp_chunk_ptr = new_chunk_sub();
+	if (temp_chunk_ptr == nullptr) { return false; }
+	if (tail_chunk_ptr != nullptr)
+	{
+		tail_chunk_ptr->next_chunk_ptr = temp_chunk_ptr;
+	}
+	else
+	{
+		head_chunk_ptr = temp_chunk_ptr;
+		next_cell_ptr = temp_chunk_ptr->cells_data_ptr;
+		head_end_ptr = next_cell_ptr + chunk_size;
+	}
+	tail_chunk_ptr = temp_chunk_ptr;
+	last_cell_ptr = temp_chunk_ptr->cells_data_ptr;
+	tail_end_ptr = last_cell_ptr + chunk_size;
+	return true;
+}
+
+// the head chunk is drained, it is released unless it is also the tail chunk, which is then reused from its beginning
+template <class Ty, class _Allocator, std::size_t chunk_size>
+inline void welp::cyclic_buffer_seg<Ty, _Allocator, chunk_size>::pop_chunk_sub() noexcept
+{
+	if (head_chunk_ptr != tail_chunk_ptr)
+	{
+		chunk* temp_chunk_ptr = head_chunk_ptr;
+		head_chunk_ptr = temp_chunk_ptr->next_chunk_ptr;
+		release_chunk_sub(temp_chunk_ptr);
+		next_cell_ptr = head_chunk_ptr->cells_data_ptr;
+		head_end_ptr = next_cell_ptr + chunk_size;
+	}
+	else
+	{
+		next_cell_ptr = head_chunk_ptr->cells_data_ptr;
+		last_cell_ptr = next_cell_ptr;
+	}
+}
+
+template <class Ty, class _Allocator, std::size_t chunk_size>
+inline bool welp::cyclic_buffer_seg<Ty, _Allocator, chunk_size>::store_cpy(const Ty& obj)
+{
+	if ((last_cell_ptr != tail_end_ptr) || push_chunk_sub())
+	{
+		new (last_cell_ptr) Ty(obj);
+		last_cell_ptr++;
+		_size++;
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+template <class Ty, class _Allocator, std::size_t chunk_size>
+inline bool welp::cyclic_buffer_seg<Ty, _Allocator, chunk_size>::store_move(Ty&& obj)
+{
+	if ((last_cell_ptr != tail_end_ptr) || push_chunk_sub())
+	{
+		new (last_cell_ptr) Ty(std::move(obj));
+		last_cell_ptr++;
+		_size++;
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+template <class Ty, class _Allocator, std::size_t chunk_size>
+template <class ... _Args> inline bool welp::cyclic_buffer_seg<Ty, _Allocator, chunk_size>::store_emplace(_Args&& ... args)
+{
+	if ((last_cell_ptr != tail_end_ptr) || push_chunk_sub())
+	{
+		new (last_cell_ptr) Ty(std::forward<_Args>(args)...);
+		last_cell_ptr++;
+		_size++;
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+template <class Ty, class _Allocator, std::size_t chunk_size>
+inline bool welp::cyclic_buffer_seg<Ty, _Allocator, chunk_size>::load(Ty& obj) noexcept
+{
+	if (_size != 0)
+	{
+		obj = std::move(*next_cell_ptr);
+		next_cell_ptr->~Ty();
+		next_cell_ptr++;
+		_size--;
+		if (next_cell_ptr == head_end_ptr) { pop_chunk_sub(); }
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+template <class Ty, class _Allocator, std::size_t chunk_size>
+inline std::size_t welp::cyclic_buffer_seg<Ty, _Allocator, chunk_size>::size() const noexcept
+{
+	return _size;
+}
+
+template <class Ty, class _Allocator, std::size_t chunk_size>
+inline std::size_t welp::cyclic_buffer_seg<Ty, _Allocator, chunk_size>::capacity() const noexcept
+{
+	return chunks * chunk_size;
+}
+
+template <class Ty, class _Allocator, std::size_t chunk_size>
+inline std::size_t welp::cyclic_buffer_seg<Ty, _Allocator, chunk_size>::chunk_count() const noexcept
+{
+	return chunks;
+}
+
+template <class Ty, class _Allocator, std::size_t chunk_size>
+bool welp::cyclic_buffer_seg<Ty, _Allocator, chunk_size>::new_buffer(std::size_t instances)
+{
+	delete_buffer();
+
+	std::size_t reserved_chunks = (instances + chunk_size - 1) / chunk_size;
+	try
+	{
+		for (std::size_t n = reserved_chunks; n > 0; n--)
+		{
+			chunk* temp_chunk_ptr = allocate_chunk_sub();
+			if (temp_chunk_ptr == nullptr)
+			{
+				delete_buffer(); return false;
+			}
+			max_cached_chunks++;
+			release_chunk_sub(temp_chunk_ptr);
+		}
+		return true;
+	}
+	catch (...)
+	{
+		delete_buffer(); return false;
+	}
+}
+
+template <class Ty, class _Allocator, std::size_t chunk_size>
+void welp::cyclic_buffer_seg<Ty, _Allocator, chunk_size>::delete_buffer() noexcept
+{
+	for (; _size > 0; _size--)
+	{
+		next_cell_ptr->~Ty();
+		next_cell_ptr++;
+		if (next_cell_ptr == head_end_ptr) { pop_chunk_sub(); }
+	}
+	max_cached_chunks = 0;
+	if (head_chunk_ptr != nullptr)
+	{
+		release_chunk_sub(head_chunk_ptr);
+	}
+	while (cached_chunk_ptr != nullptr)
+	{
+		chunk* temp_chunk_ptr = cached_chunk_ptr;
+		cached_chunk_ptr = temp_chunk_ptr->next_chunk_ptr;
+		release_chunk_sub(temp_chunk_ptr);
+	}
+	head_chunk_ptr = nullptr;
+	tail_chunk_ptr = nullptr;
+	next_cell_ptr = nullptr;
+	head_end_ptr = nullptr;
+	last_cell_ptr = nullptr;
+	tail_end_ptr = nullptr;
+	cached_chunks = 0;
+}
+
 #ifdef WELP_CYCLIC_BUFFER_INCLUDE_ATOMIC
 template <class Ty, class _Allocator, std::size_t padding_size>
 inline bool welp::cyclic_buffer_atom<Ty, _Allocator, padding_size>::store_cpy(const Ty& obj)
@@ -814,11 +1759,1076 @@ void welp::cyclic_buffer_atom<Ty, _Allocator, padding_size>::delete_buffer() noe
 		_capacity = 0;
 	}
 }
-#endif // WELP_CYCLIC_BUFFER_INCLUDE_ATOMIC
 
-#ifdef WELP_CYCLIC_BUFFER_INCLUDE_MUTEX
-template <class Ty, class _Allocator, class mutex_Ty>
-inline bool welp::cyclic_buffer_sync<Ty, _Allocator, mutex_Ty>::store_cpy(const Ty& obj)
+
+// finds the cell to store into, only reloads the index of the loading thread if the buffer looks full
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline bool welp::cyclic_buffer_spsc<Ty, _Allocator, padding_size>::store_sub(std::size_t& temp_last_cell_index, std::size_t& final_last_cell_index) noexcept
+{
+	temp_last_cell_index = last_cell_index.load(std::memory_order_relaxed);
+	final_last_cell_index = temp_last_cell_index + 1;
+	if (final_last_cell_index == cell_count) { final_last_cell_index = 0; }
+	if (final_last_cell_index == cached_next_cell_index)
+	{
+		// without buffer, returns before the reload to keep the sentinel of cached_next_cell_index
+		if (cell_count == 0) { return false; }
+		cached_next_cell_index = next_cell_index.load(std::memory_order_acquire);
+		if (final_last_cell_index == cached_next_cell_index)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline bool welp::cyclic_buffer_spsc<Ty, _Allocator, padding_size>::store_cpy(const Ty& obj)
+{
+	std::size_t temp_last_cell_index;
+	std::size_t final_last_cell_index;
+	if (store_sub(temp_last_cell_index, final_last_cell_index))
+	{
+		*(cells_data_ptr + temp_last_cell_index) = obj;
+		last_cell_index.store(final_last_cell_index, std::memory_order_release);
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline bool welp::cyclic_buffer_spsc<Ty, _Allocator, padding_size>::store_move(Ty&& obj) noexcept
+{
+	std::size_t temp_last_cell_index;
+	std::size_t final_last_cell_index;
+	if (store_sub(temp_last_cell_index, final_last_cell_index))
+	{
+		*(cells_data_ptr + temp_last_cell_index) = std::move(obj);
+		last_cell_index.store(final_last_cell_index, std::memory_order_release);
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline std::size_t welp::cyclic_buffer_spsc<Ty, _Allocator, padding_size>::store_n_sub(std::size_t temp_last_cell_index, std::size_t n) noexcept
+{
+	if (cell_count == 0) { return 0; }
+	std::size_t free_n = (cached_next_cell_index > temp_last_cell_index) ? cached_next_cell_index - temp_last_cell_index - 1
+		: cell_count - (temp_last_cell_index - cached_next_cell_index) - 1;
+	if (free_n < n)
+	{
+		cached_next_cell_index = next_cell_index.load(std::memory_order_acquire);
+		free_n = (cached_next_cell_index > temp_last_cell_index) ? cached_next_cell_index - temp_last_cell_index - 1
+			: cell_count - (temp_last_cell_index - cached_next_cell_index) - 1;
+	}
+	return (free_n < n) ? free_n : n;
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline std::size_t welp::cyclic_buffer_spsc<Ty, _Allocator, padding_size>::store_n(const Ty* obj_ptr, std::size_t n)
+{
+	std::size_t temp_last_cell_index = last_cell_index.load(std::memory_order_relaxed);
+	n = store_n_sub(temp_last_cell_index, n);
+	std::size_t first_n = cell_count - temp_last_cell_index;
+	if (first_n > n) { first_n = n; }
+	Ty* const first_ptr = cells_data_ptr + temp_last_cell_index;
+	for (std::size_t k = 0; k < first_n; k++) { *(first_ptr + k) = *(obj_ptr + k); }
+	for (std::size_t k = first_n; k < n; k++) { *(cells_data_ptr + (k - first_n)) = *(obj_ptr + k); }
+	temp_last_cell_index += n;
+	if (temp_last_cell_index >= cell_count) { temp_last_cell_index -= cell_count; }
+	last_cell_index.store(temp_last_cell_index, std::memory_order_release);
+	return n;
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline welp::cyclic_buffer_span<Ty> welp::cyclic_buffer_spsc<Ty, _Allocator, padding_size>::reserve_write(std::size_t n) noexcept
+{
+	std::size_t temp_last_cell_index = last_cell_index.load(std::memory_order_relaxed);
+	n = store_n_sub(temp_last_cell_index, n);
+	welp::cyclic_buffer_span<Ty> span;
+	span.first_ptr = cells_data_ptr + temp_last_cell_index;
+	span.first_size = cell_count - temp_last_cell_index;
+	if (span.first_size > n) { span.first_size = n; }
+	span.second_ptr = cells_data_ptr;
+	span.second_size = n - span.first_size;
+	return span;
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline void welp::cyclic_buffer_spsc<Ty, _Allocator, padding_size>::commit_write(std::size_t n) noexcept
+{
+	std::size_t temp_last_cell_index = last_cell_index.load(std::memory_order_relaxed) + n;
+	if (temp_last_cell_index >= cell_count) { temp_last_cell_index -= cell_count; }
+	last_cell_index.store(temp_last_cell_index, std::memory_order_release);
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline bool welp::cyclic_buffer_spsc<Ty, _Allocator, padding_size>::load(Ty& obj) noexcept
+{
+	std::size_t temp_next_cell_index = next_cell_index.load(std::memory_order_relaxed);
+	if (temp_next_cell_index == cached_last_cell_index)
+	{
+		cached_last_cell_index = last_cell_index.load(std::memory_order_acquire);
+		if (temp_next_cell_index == cached_last_cell_index)
+		{
+			return false;
+		}
+	}
+	obj = std::move(*(cells_data_ptr + temp_next_cell_index));
+	temp_next_cell_index++;
+	if (temp_next_cell_index == cell_count) { temp_next_cell_index = 0; }
+	next_cell_index.store(temp_next_cell_index, std::memory_order_release);
+	return true;
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline std::size_t welp::cyclic_buffer_spsc<Ty, _Allocator, padding_size>::load_n(Ty* obj_ptr, std::size_t n) noexcept
+{
+	std::size_t temp_next_cell_index = next_cell_index.load(std::memory_order_relaxed);
+	std::size_t available_n = (cached_last_cell_index >= temp_next_cell_index) ? cached_last_cell_index - temp_next_cell_index
+		: cell_count - (temp_next_cell_index - cached_last_cell_index);
+	if (available_n < n)
+	{
+		cached_last_cell_index = last_cell_index.load(std::memory_order_acquire);
+		available_n = (cached_last_cell_index >= temp_next_cell_index) ? cached_last_cell_index - temp_next_cell_index
+			: cell_count - (temp_next_cell_index - cached_last_cell_index);
+	}
+	if (n > available_n) { n = available_n; }
+	std::size_t first_n = cell_count - temp_next_cell_index;
+	if (first_n > n) { first_n = n; }
+	Ty* const first_ptr = cells_data_ptr + temp_next_cell_index;
+	for (std::size_t k = 0; k < first_n; k++) { *(obj_ptr + k) = std::move(*(first_ptr + k)); }
+	for (std::size_t k = first_n; k < n; k++) { *(obj_ptr + k) = std::move(*(cells_data_ptr + (k - first_n))); }
+	temp_next_cell_index += n;
+	if (temp_next_cell_index >= cell_count) { temp_next_cell_index -= cell_count; }
+	next_cell_index.store(temp_next_cell_index, std::memory_order_release);
+	return n;
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline std::size_t welp::cyclic_buffer_spsc<Ty, _Allocator, padding_size>::size() const noexcept
+{
+	std::size_t temp_last_cell_index = last_cell_index.load(std::memory_order_acquire);
+	std::size_t temp_next_cell_index = next_cell_index.load(std::memory_order_acquire);
+	if (temp_last_cell_index >= temp_next_cell_index)
+	{
+		return temp_last_cell_index - temp_next_cell_index;
+	}
+	else
+	{
+		return cell_count - (temp_next_cell_index - temp_last_cell_index);
+	}
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline std::size_t welp::cyclic_buffer_spsc<Ty, _Allocator, padding_size>::capacity() const noexcept
+{
+	return _capacity;
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline std::size_t welp::cyclic_buffer_spsc<Ty, _Allocator, padding_size>::capacity_remaining() const noexcept
+{
+	return _capacity - size();
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+bool welp::cyclic_buffer_spsc<Ty, _Allocator, padding_size>::new_buffer(std::size_t instances)
+{
+	delete_buffer();
+
+	try
+	{
+		cells_data_ptr = static_cast<Ty*>(static_cast<void*>(
+			this->allocate((instances + 1) * sizeof(Ty))));
+		if (cells_data_ptr != nullptr)
+		{
+			_capacity = instances;
+			for (std::size_t n = 0; n < instances + 1; n++)
+			{
+				new (cells_data_ptr + n) Ty(); cell_count++;
+			}
+			next_cell_index.store(0, std::memory_order_relaxed);
+			last_cell_index.store(0, std::memory_order_relaxed);
+			cached_next_cell_index = 0;
+			cached_last_cell_index = 0;
+			return true;
+		}
+		else
+		{
+			delete_buffer(); return false;
+		}
+	}
+	catch (...)
+	{
+		delete_buffer(); return false;
+	}
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+void welp::cyclic_buffer_spsc<Ty, _Allocator, padding_size>::delete_buffer() noexcept
+{
+	if (cells_data_ptr != nullptr)
+	{
+		for (std::size_t n = cell_count; n > 0; n--)
+		{
+			(cells_data_ptr + n - 1)->~Ty();
+		}
+		this->deallocate(static_cast<char*>(static_cast<void*>(cells_data_ptr)), (_capacity + 1) * sizeof(Ty));
+		cells_data_ptr = nullptr;
+		cell_count = 0;
+		next_cell_index.store(0, std::memory_order_relaxed);
+		last_cell_index.store(0, std::memory_order_relaxed);
+		cached_next_cell_index = 1;
+		cached_last_cell_index = 0;
+		_capacity = 0;
+	}
+}
+
+// claims the cell of the next store, returns nullptr if the buffer is full
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline typename welp::cyclic_buffer_mpmc<Ty, _Allocator, padding_size>::storage_cell* welp::cyclic_buffer_mpmc<Ty, _Allocator, padding_size>::store_sub(std::size_t& temp_last_cell_index) noexcept
+{
+	if (cells_data_ptr == nullptr) { return nullptr; }
+	temp_last_cell_index = last_cell_index.load(std::memory_order_relaxed);
+	while (true)
+	{
+		storage_cell* temp_cell_ptr = cells_data_ptr + (temp_last_cell_index & cell_mask);
+		std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(temp_cell_ptr->sequence.load(std::memory_order_acquire) - temp_last_cell_index);
+		if (diff == 0)
+		{
+			if (last_cell_index.compare_exchange_weak(temp_last_cell_index, temp_last_cell_index + 1, std::memory_order_relaxed))
+			{
+				return temp_cell_ptr;
+			}
+		}
+		else if (diff < 0)
+		{
+			return nullptr;
+		}
+		else
+		{
+			temp_last_cell_index = last_cell_index.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+// claims the cell of the next load, returns nullptr if the buffer is empty
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline typename welp::cyclic_buffer_mpmc<Ty, _Allocator, padding_size>::storage_cell* welp::cyclic_buffer_mpmc<Ty, _Allocator, padding_size>::load_sub(std::size_t& temp_next_cell_index) noexcept
+{
+	if (cells_data_ptr == nullptr) { return nullptr; }
+	temp_next_cell_index = next_cell_index.load(std::memory_order_relaxed);
+	while (true)
+	{
+		storage_cell* temp_cell_ptr = cells_data_ptr + (temp_next_cell_index & cell_mask);
+		std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(temp_cell_ptr->sequence.load(std::memory_order_acquire) - (temp_next_cell_index + 1));
+		if (diff == 0)
+		{
+			if (next_cell_index.compare_exchange_weak(temp_next_cell_index, temp_next_cell_index + 1, std::memory_order_relaxed))
+			{
+				return temp_cell_ptr;
+			}
+		}
+		else if (diff < 0)
+		{
+			return nullptr;
+		}
+		else
+		{
+			temp_next_cell_index = next_cell_index.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+// the fence orders the sequence store before the waiter count load, a waiter increments the count before trying again
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline void welp::cyclic_buffer_mpmc<Ty, _Allocator, padding_size>::notify_store_sub()
+{
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (store_waiters.load(std::memory_order_relaxed) != 0)
+	{
+		std::lock_guard<std::mutex> _lock(wait_mutex);
+		store_condition_var.notify_one();
+	}
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline void welp::cyclic_buffer_mpmc<Ty, _Allocator, padding_size>::notify_load_sub()
+{
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (load_waiters.load(std::memory_order_relaxed) != 0)
+	{
+		std::lock_guard<std::mutex> _lock(wait_mutex);
+		load_condition_var.notify_one();
+	}
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline bool welp::cyclic_buffer_mpmc<Ty, _Allocator, padding_size>::store_cpy(const Ty& obj)
+{
+	std::size_t temp_last_cell_index;
+	storage_cell* temp_cell_ptr = store_sub(temp_last_cell_index);
+	if (temp_cell_ptr != nullptr)
+	{
+		temp_cell_ptr->storage = obj;
+		temp_cell_ptr->sequence.store(temp_last_cell_index + 1, std::memory_order_release);
+		notify_load_sub();
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline bool welp::cyclic_buffer_mpmc<Ty, _Allocator, padding_size>::store_move(Ty&& obj) noexcept
+{
+	std::size_t temp_last_cell_index;
+	storage_cell* temp_cell_ptr = store_sub(temp_last_cell_index);
+	if (temp_cell_ptr != nullptr)
+	{
+		temp_cell_ptr->storage = std::move(obj);
+		temp_cell_ptr->sequence.store(temp_last_cell_index + 1, std::memory_order_release);
+		notify_load_sub();
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline bool welp::cyclic_buffer_mpmc<Ty, _Allocator, padding_size>::store_wait(const Ty& obj)
+{
+	if (store_cpy(obj)) { return true; }
+	if (cells_data_ptr == nullptr) { return false; }
+
+	std::size_t temp_last_cell_index;
+	storage_cell* temp_cell_ptr;
+	{
+		std::unique_lock<std::mutex> _lock(wait_mutex);
+		store_waiters.fetch_add(1);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		while ((temp_cell_ptr = store_sub(temp_last_cell_index)) == nullptr)
+		{
+			store_condition_var.wait(_lock);
+		}
+		store_waiters.fetch_sub(1, std::memory_order_relaxed);
+	}
+	temp_cell_ptr->storage = obj;
+	temp_cell_ptr->sequence.store(temp_last_cell_index + 1, std::memory_order_release);
+	notify_load_sub();
+	return true;
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline bool welp::cyclic_buffer_mpmc<Ty, _Allocator, padding_size>::store_wait(Ty&& obj)
+{
+	if (store_move(std::move(obj))) { return true; }
+	if (cells_data_ptr == nullptr) { return false; }
+
+	std::size_t temp_last_cell_index;
+	storage_cell* temp_cell_ptr;
+	{
+		std::unique_lock<std::mutex> _lock(wait_mutex);
+		store_waiters.fetch_add(1);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		while ((temp_cell_ptr = store_sub(temp_last_cell_index)) == nullptr)
+		{
+			store_condition_var.wait(_lock);
+		}
+		store_waiters.fetch_sub(1, std::memory_order_relaxed);
+	}
+	temp_cell_ptr->storage = std::move(obj);
+	temp_cell_ptr->sequence.store(temp_last_cell_index + 1, std::memory_order_release);
+	notify_load_sub();
+	return true;
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline bool welp::cyclic_buffer_mpmc<Ty, _Allocator, padding_size>::load(Ty& obj) noexcept
+{
+	std::size_t temp_next_cell_index;
+	storage_cell* temp_cell_ptr = load_sub(temp_next_cell_index);
+	if (temp_cell_ptr != nullptr)
+	{
+		obj = std::move(temp_cell_ptr->storage);
+		temp_cell_ptr->sequence.store(temp_next_cell_index + cell_mask + 1, std::memory_order_release);
+		notify_store_sub();
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline bool welp::cyclic_buffer_mpmc<Ty, _Allocator, padding_size>::load_wait(Ty& obj)
+{
+	if (load(obj)) { return true; }
+	if (cells_data_ptr == nullptr) { return false; }
+
+	std::size_t temp_next_cell_index;
+	storage_cell* temp_cell_ptr;
+	{
+		std::unique_lock<std::mutex> _lock(wait_mutex);
+		load_waiters.fetch_add(1);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		while ((temp_cell_ptr = load_sub(temp_next_cell_index)) == nullptr)
+		{
+			load_condition_var.wait(_lock);
+		}
+		load_waiters.fetch_sub(1, std::memory_order_relaxed);
+	}
+	obj = std::move(temp_cell_ptr->storage);
+	temp_cell_ptr->sequence.store(temp_next_cell_index + cell_mask + 1, std::memory_order_release);
+	notify_store_sub();
+	return true;
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline std::size_t welp::cyclic_buffer_mpmc<Ty, _Allocator, padding_size>::size() const noexcept
+{
+	std::size_t temp_next_cell_index = next_cell_index.load();
+	std::size_t temp_last_cell_index = last_cell_index.load();
+	std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(temp_last_cell_index - temp_next_cell_index);
+	if (diff <= 0) { return 0; }
+	return (static_cast<std::size_t>(diff) < _capacity) ? static_cast<std::size_t>(diff) : _capacity;
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline std::size_t welp::cyclic_buffer_mpmc<Ty, _Allocator, padding_size>::capacity() const noexcept
+{
+	return _capacity;
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline std::size_t welp::cyclic_buffer_mpmc<Ty, _Allocator, padding_size>::capacity_remaining() const noexcept
+{
+	return _capacity - size();
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+bool welp::cyclic_buffer_mpmc<Ty, _Allocator, padding_size>::new_buffer(std::size_t instances)
+{
+	delete_buffer();
+
+	std::size_t cell_count = 2;
+	while (cell_count < instances) { cell_count <<= 1; }
+
+	try
+	{
+		cells_data_ptr = static_cast<storage_cell*>(static_cast<void*>(
+			this->allocate(cell_count * sizeof(storage_cell))));
+		if (cells_data_ptr != nullptr)
+		{
+			cell_mask = cell_count - 1;
+			for (std::size_t n = 0; n < cell_count; n++)
+			{
+				new (cells_data_ptr + n) storage_cell(); _capacity++;
+				(cells_data_ptr + n)->sequence.store(n, std::memory_order_relaxed);
+			}
+			next_cell_index.store(0, std::memory_order_relaxed);
+			last_cell_index.store(0, std::memory_order_relaxed);
+			return true;
+		}
+		else
+		{
+			delete_buffer(); return false;
+		}
+	}
+	catch (...)
+	{
+		delete_buffer(); return false;
+	}
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+void welp::cyclic_buffer_mpmc<Ty, _Allocator, padding_size>::delete_buffer() noexcept
+{
+	if (cells_data_ptr != nullptr)
+	{
+		std::size_t cell_count = cell_mask + 1;
+		for (std::size_t n = _capacity; n > 0; n--)
+		{
+			(cells_data_ptr + n - 1)->~storage_cell();
+		}
+		this->deallocate(static_cast<char*>(static_cast<void*>(cells_data_ptr)), cell_count * sizeof(storage_cell));
+		cells_data_ptr = nullptr;
+		cell_mask = 0;
+		next_cell_index.store(0, std::memory_order_relaxed);
+		last_cell_index.store(0, std::memory_order_relaxed);
+		_capacity = 0;
+	}
+}
+
+// to be called after the cells have been copied, the objects before the returned index may have been overwritten during the copy
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline std::size_t welp::cyclic_buffer_lossy<Ty, _Allocator, padding_size>::first_valid_index_sub() const noexcept
+{
+	std::atomic_thread_fence(std::memory_order_acquire);
+	std::size_t temp_writing_index = writing_index.load(std::memory_order_relaxed);
+	return (temp_writing_index > _capacity) ? temp_writing_index - _capacity : 0;
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline bool welp::cyclic_buffer_lossy<Ty, _Allocator, padding_size>::store_cpy(const Ty& obj) noexcept
+{
+	if (last_cell_ptr != nullptr)
+	{
+		std::size_t temp_index = written_index.load(std::memory_order_relaxed);
+		writing_index.store(temp_index + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		*last_cell_ptr = obj;
+		last_cell_ptr++;
+		if (last_cell_ptr == cells_end_ptr) { last_cell_ptr = cells_data_ptr; }
+		written_index.store(temp_index + 1, std::memory_order_release);
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline bool welp::cyclic_buffer_lossy<Ty, _Allocator, padding_size>::store_move(Ty&& obj) noexcept
+{
+	if (last_cell_ptr != nullptr)
+	{
+		std::size_t temp_index = written_index.load(std::memory_order_relaxed);
+		writing_index.store(temp_index + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		*last_cell_ptr = std::move(obj);
+		last_cell_ptr++;
+		if (last_cell_ptr == cells_end_ptr) { last_cell_ptr = cells_data_ptr; }
+		written_index.store(temp_index + 1, std::memory_order_release);
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline bool welp::cyclic_buffer_lossy<Ty, _Allocator, padding_size>::load(Ty& obj) noexcept
+{
+	std::size_t temp_next_index = next_index.load(std::memory_order_relaxed);
+	while (true)
+	{
+		std::size_t end_index = written_index.load(std::memory_order_acquire);
+		if (temp_next_index == end_index)
+		{
+			return false;
+		}
+		if (end_index - temp_next_index > _capacity)
+		{
+			skipped.store(skipped.load(std::memory_order_relaxed) + (end_index - _capacity - temp_next_index), std::memory_order_relaxed);
+			temp_next_index = end_index - _capacity;
+			next_index.store(temp_next_index, std::memory_order_release);
+		}
+
+		obj = *(cells_data_ptr + (temp_next_index % _capacity));
+
+		std::size_t first_valid_index = first_valid_index_sub();
+		if (temp_next_index >= first_valid_index)
+		{
+			next_index.store(temp_next_index + 1, std::memory_order_release);
+			return true;
+		}
+		skipped.store(skipped.load(std::memory_order_relaxed) + (first_valid_index - temp_next_index), std::memory_order_relaxed);
+		temp_next_index = first_valid_index;
+		next_index.store(temp_next_index, std::memory_order_release);
+	}
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline std::size_t welp::cyclic_buffer_lossy<Ty, _Allocator, padding_size>::snapshot(Ty* obj_ptr, std::size_t n) const noexcept
+{
+	while (true)
+	{
+		std::size_t end_index = written_index.load(std::memory_order_acquire);
+		std::size_t count = (n < end_index) ? n : end_index;
+		if (count > _capacity) { count = _capacity; }
+		if (count == 0) { return 0; }
+		std::size_t begin_index = end_index - count;
+
+		const Ty* temp_cell_ptr = cells_data_ptr + (begin_index % _capacity);
+		std::size_t first_n = static_cast<std::size_t>(cells_end_ptr - temp_cell_ptr);
+		if (first_n > count) { first_n = count; }
+		for (std::size_t k = 0; k < first_n; k++) { *(obj_ptr + k) = *(temp_cell_ptr + k); }
+		for (std::size_t k = first_n; k < count; k++) { *(obj_ptr + k) = *(cells_data_ptr + (k - first_n)); }
+
+		std::size_t first_valid_index = first_valid_index_sub();
+		if (begin_index >= first_valid_index)
+		{
+			return count;
+		}
+		std::size_t skipped_n = first_valid_index - begin_index;
+		if (skipped_n < count)
+		{
+			count -= skipped_n;
+			for (std::size_t k = 0; k < count; k++) { *(obj_ptr + k) = *(obj_ptr + (k + skipped_n)); }
+			return count;
+		}
+	}
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline std::size_t welp::cyclic_buffer_lossy<Ty, _Allocator, padding_size>::dropped() const noexcept
+{
+	std::size_t temp_next_index = next_index.load(std::memory_order_acquire);
+	std::size_t temp_skipped = skipped.load(std::memory_order_relaxed);
+	std::size_t end_index = written_index.load(std::memory_order_acquire);
+	return temp_skipped + ((end_index - temp_next_index > _capacity) ? end_index - temp_next_index - _capacity : 0);
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline std::size_t welp::cyclic_buffer_lossy<Ty, _Allocator, padding_size>::size() const noexcept
+{
+	std::size_t temp_next_index = next_index.load(std::memory_order_acquire);
+	std::size_t end_index = written_index.load(std::memory_order_acquire);
+	return (end_index - temp_next_index < _capacity) ? end_index - temp_next_index : _capacity;
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline std::size_t welp::cyclic_buffer_lossy<Ty, _Allocator, padding_size>::capacity() const noexcept
+{
+	return _capacity;
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+bool welp::cyclic_buffer_lossy<Ty, _Allocator, padding_size>::new_buffer(std::size_t instances)
+{
+	delete_buffer();
+
+	if (instances == 0) { return false; }
+	cells_data_ptr = static_cast<Ty*>(static_cast<void*>(this->allocate(instances * sizeof(Ty))));
+	if (cells_data_ptr != nullptr)
+	{
+		for (std::size_t n = 0; n < instances; n++)
+		{
+			new (cells_data_ptr + n) Ty();
+		}
+		cells_end_ptr = cells_data_ptr + instances;
+		last_cell_ptr = cells_data_ptr;
+		_capacity = instances;
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+void welp::cyclic_buffer_lossy<Ty, _Allocator, padding_size>::delete_buffer() noexcept
+{
+	if (cells_data_ptr != nullptr)
+	{
+		this->deallocate(static_cast<char*>(static_cast<void*>(cells_data_ptr)), _capacity * sizeof(Ty));
+		cells_data_ptr = nullptr;
+		cells_end_ptr = nullptr;
+		last_cell_ptr = nullptr;
+		_capacity = 0;
+		writing_index.store(0, std::memory_order_relaxed);
+		written_index.store(0, std::memory_order_relaxed);
+		next_index.store(0, std::memory_order_relaxed);
+		skipped.store(0, std::memory_order_relaxed);
+	}
+}
+
+template <class Ty, std::size_t padding_size>
+constexpr std::size_t welp::cyclic_buffer_shm<Ty, padding_size>::layout_tag;
+
+template <class Ty, std::size_t padding_size>
+std::size_t welp::cyclic_buffer_shm<Ty, padding_size>::cells_offset_sub() noexcept
+{
+	return ((sizeof(shared_header) + alignof(storage_cell) - 1) / alignof(storage_cell)) * alignof(storage_cell);
+}
+
+template <class Ty, std::size_t padding_size>
+std::size_t welp::cyclic_buffer_shm<Ty, padding_size>::cell_count_sub(std::size_t instances) noexcept
+{
+	std::size_t cell_count = 2;
+	while (cell_count < instances) { cell_count <<= 1; }
+	return cell_count;
+}
+
+template <class Ty, std::size_t padding_size>
+std::size_t welp::cyclic_buffer_shm<Ty, padding_size>::required_bytes(std::size_t instances) noexcept
+{
+	return cells_offset_sub() + cell_count_sub(instances) * sizeof(storage_cell);
+}
+
+template <class Ty, std::size_t padding_size>
+bool welp::cyclic_buffer_shm<Ty, padding_size>::region_check_sub(void* region_ptr, std::size_t region_bytes) noexcept
+{
+	std::size_t alignment = (alignof(shared_header) > alignof(storage_cell)) ? alignof(shared_header) : alignof(storage_cell);
+	return (region_ptr != nullptr) && (region_bytes >= cells_offset_sub())
+		&& (reinterpret_cast<std::uintptr_t>(region_ptr) % alignment == 0);
+}
+
+template <class Ty, std::size_t padding_size>
+bool welp::cyclic_buffer_shm<Ty, padding_size>::create(void* region_ptr, std::size_t region_bytes, std::size_t instances) noexcept
+{
+	detach();
+
+	std::size_t cell_count = cell_count_sub(instances);
+	if (!region_check_sub(region_ptr, region_bytes) || (region_bytes < required_bytes(instances)))
+	{
+		return false;
+	}
+
+	shared_header* temp_header_ptr = new (region_ptr) shared_header();
+	if (!temp_header_ptr->ready.is_lock_free())
+	{
+		temp_header_ptr->~shared_header();
+		return false;
+	}
+	temp_header_ptr->cell_count = cell_count;
+	temp_header_ptr->cell_bytes = sizeof(storage_cell);
+	temp_header_ptr->cells_offset = cells_offset_sub();
+
+	storage_cell* temp_cells_ptr = static_cast<storage_cell*>(static_cast<void*>(
+		static_cast<char*>(region_ptr) + temp_header_ptr->cells_offset));
+	for (std::size_t n = 0; n < cell_count; n++)
+	{
+		new (temp_cells_ptr + n) storage_cell();
+		(temp_cells_ptr + n)->sequence.store(n, std::memory_order_relaxed);
+	}
+	temp_header_ptr->ready.store(layout_tag, std::memory_order_release);
+
+	header_ptr = temp_header_ptr;
+	cells_data_ptr = temp_cells_ptr;
+	cell_mask = cell_count - 1;
+	return true;
+}
+
+template <class Ty, std::size_t padding_size>
+bool welp::cyclic_buffer_shm<Ty, padding_size>::attach(void* region_ptr, std::size_t region_bytes) noexcept
+{
+	detach();
+
+	if (!region_check_sub(region_ptr, region_bytes))
+	{
+		return false;
+	}
+
+	shared_header* temp_header_ptr = static_cast<shared_header*>(region_ptr);
+	if ((temp_header_ptr->ready.load(std::memory_order_acquire) != layout_tag)
+		|| (temp_header_ptr->cell_bytes != sizeof(storage_cell))
+		|| (temp_header_ptr->cells_offset != cells_offset_sub())
+		|| (temp_header_ptr->cell_count < 2) || ((temp_header_ptr->cell_count & (temp_header_ptr->cell_count - 1)) != 0)
+		|| (region_bytes < cells_offset_sub() + temp_header_ptr->cell_count * sizeof(storage_cell)))
+	{
+		return false;
+	}
+
+	header_ptr = temp_header_ptr;
+	cells_data_ptr = static_cast<storage_cell*>(static_cast<void*>(
+		static_cast<char*>(region_ptr) + temp_header_ptr->cells_offset));
+	cell_mask = temp_header_ptr->cell_count - 1;
+	return true;
+}
+
+// the region itself is left as it is, other processes may still use it
+template <class Ty, std::size_t padding_size>
+void welp::cyclic_buffer_shm<Ty, padding_size>::detach() noexcept
+{
+	header_ptr = nullptr;
+	cells_data_ptr = nullptr;
+	cell_mask = 0;
+}
+
+template <class Ty, std::size_t padding_size>
+inline bool welp::cyclic_buffer_shm<Ty, padding_size>::store_cpy(const Ty& obj) noexcept
+{
+	if (header_ptr == nullptr) { return false; }
+	std::size_t temp_last_cell_index = header_ptr->last_cell_index.load(std::memory_order_relaxed);
+	while (true)
+	{
+		storage_cell* temp_cell_ptr = cells_data_ptr + (temp_last_cell_index & cell_mask);
+		std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(temp_cell_ptr->sequence.load(std::memory_order_acquire) - temp_last_cell_index);
+		if (diff == 0)
+		{
+			if (header_ptr->last_cell_index.compare_exchange_weak(temp_last_cell_index, temp_last_cell_index + 1, std::memory_order_relaxed))
+			{
+				temp_cell_ptr->storage = obj;
+				temp_cell_ptr->sequence.store(temp_last_cell_index + 1, std::memory_order_release);
+				return true;
+			}
+		}
+		else if (diff < 0)
+		{
+			return false;
+		}
+		else
+		{
+			temp_last_cell_index = header_ptr->last_cell_index.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+template <class Ty, std::size_t padding_size>
+inline bool welp::cyclic_buffer_shm<Ty, padding_size>::load(Ty& obj) noexcept
+{
+	if (header_ptr == nullptr) { return false; }
+	std::size_t temp_next_cell_index = header_ptr->next_cell_index.load(std::memory_order_relaxed);
+	while (true)
+	{
+		storage_cell* temp_cell_ptr = cells_data_ptr + (temp_next_cell_index & cell_mask);
+		std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(temp_cell_ptr->sequence.load(std::memory_order_acquire) - (temp_next_cell_index + 1));
+		if (diff == 0)
+		{
+			if (header_ptr->next_cell_index.compare_exchange_weak(temp_next_cell_index, temp_next_cell_index + 1, std::memory_order_relaxed))
+			{
+				obj = temp_cell_ptr->storage;
+				temp_cell_ptr->sequence.store(temp_next_cell_index + cell_mask + 1, std::memory_order_release);
+				return true;
+			}
+		}
+		else if (diff < 0)
+		{
+			return false;
+		}
+		else
+		{
+			temp_next_cell_index = header_ptr->next_cell_index.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+template <class Ty, std::size_t padding_size>
+inline std::size_t welp::cyclic_buffer_shm<Ty, padding_size>::size() const noexcept
+{
+	if (header_ptr == nullptr) { return 0; }
+	std::size_t temp_next_cell_index = header_ptr->next_cell_index.load();
+	std::size_t temp_last_cell_index = header_ptr->last_cell_index.load();
+	std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(temp_last_cell_index - temp_next_cell_index);
+	if (diff <= 0) { return 0; }
+	return (static_cast<std::size_t>(diff) < cell_mask + 1) ? static_cast<std::size_t>(diff) : cell_mask + 1;
+}
+
+template <class Ty, std::size_t padding_size>
+inline std::size_t welp::cyclic_buffer_shm<Ty, padding_size>::capacity() const noexcept
+{
+	return (header_ptr != nullptr) ? cell_mask + 1 : 0;
+}
+
+template <class Ty, std::size_t padding_size>
+inline std::size_t welp::cyclic_buffer_shm<Ty, padding_size>::capacity_remaining() const noexcept
+{
+	return capacity() - size();
+}
+
+// only reloads the reader cursors if the buffer looks full from the last lowest cursor seen
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline bool welp::cyclic_buffer_broadcast<Ty, _Allocator, padding_size>::store_sub(std::size_t temp_index) noexcept
+{
+	if (temp_index - cached_min_index < _capacity)
+	{
+		return true;
+	}
+	if (_readers == 0)
+	{
+		return false;
+	}
+	std::size_t min_index = readers_data_ptr->next_index.load(std::memory_order_acquire);
+	for (std::size_t n = 1; n < _readers; n++)
+	{
+		std::size_t reader_index = (readers_data_ptr + n)->next_index.load(std::memory_order_acquire);
+		if (static_cast<std::ptrdiff_t>(reader_index - min_index) < 0) { min_index = reader_index; }
+	}
+	cached_min_index = min_index;
+	return temp_index - min_index < _capacity;
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline bool welp::cyclic_buffer_broadcast<Ty, _Allocator, padding_size>::store_cpy(const Ty& obj)
+{
+	std::size_t temp_index = written_index.load(std::memory_order_relaxed);
+	if (store_sub(temp_index))
+	{
+		*(cells_data_ptr + (temp_index & cell_mask)) = obj;
+		written_index.store(temp_index + 1, std::memory_order_release);
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline bool welp::cyclic_buffer_broadcast<Ty, _Allocator, padding_size>::store_move(Ty&& obj) noexcept
+{
+	std::size_t temp_index = written_index.load(std::memory_order_relaxed);
+	if (store_sub(temp_index))
+	{
+		*(cells_data_ptr + (temp_index & cell_mask)) = std::move(obj);
+		written_index.store(temp_index + 1, std::memory_order_release);
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline welp::cyclic_buffer_span<const Ty> welp::cyclic_buffer_broadcast<Ty, _Allocator, padding_size>::read(std::size_t reader, std::size_t n) noexcept
+{
+	reader_cursor* cursor_ptr = readers_data_ptr + reader;
+	std::size_t temp_next_index = cursor_ptr->next_index.load(std::memory_order_relaxed);
+	if (cursor_ptr->cached_written_index - temp_next_index < n)
+	{
+		cursor_ptr->cached_written_index = written_index.load(std::memory_order_acquire);
+	}
+	std::size_t available_n = cursor_ptr->cached_written_index - temp_next_index;
+	if (n > available_n) { n = available_n; }
+
+	welp::cyclic_buffer_span<const Ty> span;
+	std::size_t first_cell_index = temp_next_index & cell_mask;
+	span.first_ptr = cells_data_ptr + first_cell_index;
+	span.first_size = _capacity - first_cell_index;
+	if (span.first_size > n) { span.first_size = n; }
+	span.second_ptr = cells_data_ptr;
+	span.second_size = n - span.first_size;
+	return span;
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline void welp::cyclic_buffer_broadcast<Ty, _Allocator, padding_size>::release(std::size_t reader, std::size_t n) noexcept
+{
+	reader_cursor* cursor_ptr = readers_data_ptr + reader;
+	cursor_ptr->next_index.store(cursor_ptr->next_index.load(std::memory_order_relaxed) + n, std::memory_order_release);
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline bool welp::cyclic_buffer_broadcast<Ty, _Allocator, padding_size>::load(std::size_t reader, Ty& obj)
+{
+	welp::cyclic_buffer_span<const Ty> span = read(reader, 1);
+	if (span.size() != 0)
+	{
+		obj = span[0];
+		release(reader, 1);
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline std::size_t welp::cyclic_buffer_broadcast<Ty, _Allocator, padding_size>::size(std::size_t reader) const noexcept
+{
+	std::size_t temp_next_index = (readers_data_ptr + reader)->next_index.load(std::memory_order_acquire);
+	return written_index.load(std::memory_order_acquire) - temp_next_index;
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline std::size_t welp::cyclic_buffer_broadcast<Ty, _Allocator, padding_size>::capacity() const noexcept
+{
+	return _capacity;
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+inline std::size_t welp::cyclic_buffer_broadcast<Ty, _Allocator, padding_size>::number_of_readers() const noexcept
+{
+	return _readers;
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+bool welp::cyclic_buffer_broadcast<Ty, _Allocator, padding_size>::new_buffer(std::size_t instances, std::size_t readers)
+{
+	delete_buffer();
+
+	if (readers == 0) { return false; }
+	std::size_t new_cell_count = 2;
+	while (new_cell_count < instances) { new_cell_count <<= 1; }
+
+	try
+	{
+		readers_data_ptr = static_cast<reader_cursor*>(static_cast<void*>(
+			this->allocate(readers * sizeof(reader_cursor))));
+		if (readers_data_ptr == nullptr)
+		{
+			return false;
+		}
+		for (std::size_t n = 0; n < readers; n++)
+		{
+			new (readers_data_ptr + n) reader_cursor();
+		}
+		_readers = readers;
+
+		cells_data_ptr = static_cast<Ty*>(static_cast<void*>(
+			this->allocate(new_cell_count * sizeof(Ty))));
+		if (cells_data_ptr == nullptr)
+		{
+			delete_buffer(); return false;
+		}
+		cell_count = new_cell_count;
+		for (std::size_t n = 0; n < cell_count; n++)
+		{
+			new (cells_data_ptr + n) Ty(); _capacity++;
+		}
+		cell_mask = cell_count - 1;
+		written_index.store(0, std::memory_order_relaxed);
+		cached_min_index = 0;
+		return true;
+	}
+	catch (...)
+	{
+		delete_buffer(); return false;
+	}
+}
+
+template <class Ty, class _Allocator, std::size_t padding_size>
+void welp::cyclic_buffer_broadcast<Ty, _Allocator, padding_size>::delete_buffer() noexcept
+{
+	if (cells_data_ptr != nullptr)
+	{
+		for (std::size_t n = _capacity; n > 0; n--)
+		{
+			(cells_data_ptr + n - 1)->~Ty();
+		}
+		this->deallocate(static_cast<char*>(static_cast<void*>(cells_data_ptr)), cell_count * sizeof(Ty));
+		cells_data_ptr = nullptr;
+		cell_count = 0;
+	}
+	if (readers_data_ptr != nullptr)
+	{
+		for (std::size_t n = _readers; n > 0; n--)
+		{
+			(readers_data_ptr + n - 1)->~reader_cursor();
+		}
+		this->deallocate(static_cast<char*>(static_cast<void*>(readers_data_ptr)), _readers * sizeof(reader_cursor));
+		readers_data_ptr = nullptr;
+	}
+	cell_mask = 0;
+	_capacity = 0;
+	_readers = 0;
+	written_index.store(0, std::memory_order_relaxed);
+	cached_min_index = 0;
+}
+#endif // WELP_CYCLIC_BUFFER_INCLUDE_ATOMIC
+
+#ifdef WELP_CYCLIC_BUFFER_INCLUDE_MUTEX
+template <class Ty, class _Allocator, class mutex_Ty>
+inline bool welp::cyclic_buffer_sync<Ty, _Allocator, mutex_Ty>::store_cpy(const Ty& obj)
 {
 	std::lock_guard<mutex_Ty> _lock(buffer_mutex);
 
@@ -874,6 +2884,29 @@ inline bool welp::cyclic_buffer_sync<Ty, _Allocator, mutex_Ty>::store_ptr(Ty* ob
 	}
 }
 
+template <class Ty, class _Allocator, class mutex_Ty>
+inline std::size_t welp::cyclic_buffer_sync<Ty, _Allocator, mutex_Ty>::store_n(const Ty* obj_ptr, std::size_t n)
+{
+	std::lock_guard<mutex_Ty> _lock(buffer_mutex);
+
+	if (n > _capacity - _size) { n = _capacity - _size; }
+	storage_cell* temp_cell_ptr = last_cell_ptr;
+	std::size_t k = 0;
+	while (k < n)
+	{
+		std::size_t segment_n = static_cast<std::size_t>(cells_end_ptr - temp_cell_ptr);
+		if (segment_n > n - k) { segment_n = n - k; }
+		for (storage_cell* const segment_end_ptr = temp_cell_ptr + segment_n; temp_cell_ptr != segment_end_ptr; temp_cell_ptr++)
+		{
+			temp_cell_ptr->storage = *(obj_ptr + k); k++;
+		}
+		if (temp_cell_ptr == cells_end_ptr) { temp_cell_ptr = cells_data_ptr; }
+	}
+	last_cell_ptr = temp_cell_ptr;
+	_size += n;
+	return n;
+}
+
 template <class Ty, class _Allocator, class mutex_Ty>
 inline bool welp::cyclic_buffer_sync<Ty, _Allocator, mutex_Ty>::load_cpy(Ty& obj)
 {
@@ -936,6 +2969,39 @@ inline bool welp::cyclic_buffer_sync<Ty, _Allocator, mutex_Ty>::load(Ty& obj) no
 	}
 }
 
+template <class Ty, class _Allocator, class mutex_Ty>
+inline std::size_t welp::cyclic_buffer_sync<Ty, _Allocator, mutex_Ty>::load_n(Ty* obj_ptr, std::size_t n) noexcept
+{
+	std::lock_guard<mutex_Ty> _lock(buffer_mutex);
+
+	if (n > _size) { n = _size; }
+	storage_cell* temp_cell_ptr = next_cell_ptr;
+	std::size_t k = 0;
+	while (k < n)
+	{
+		std::size_t segment_n = static_cast<std::size_t>(cells_end_ptr - temp_cell_ptr);
+		if (segment_n > n - k) { segment_n = n - k; }
+		for (storage_cell* const segment_end_ptr = temp_cell_ptr + segment_n; temp_cell_ptr != segment_end_ptr; temp_cell_ptr++)
+		{
+			if (temp_cell_ptr->storage_ptr == nullptr)
+			{
+				*(obj_ptr + k) = std::move(temp_cell_ptr->storage);
+			}
+			else
+			{
+				const Ty* temp_storage_ptr = temp_cell_ptr->storage_ptr;
+				temp_cell_ptr->storage_ptr = nullptr;
+				*(obj_ptr + k) = std::move(*temp_storage_ptr);
+			}
+			k++;
+		}
+		if (temp_cell_ptr == cells_end_ptr) { temp_cell_ptr = cells_data_ptr; }
+	}
+	next_cell_ptr = temp_cell_ptr;
+	_size -= n;
+	return n;
+}
+
 template <class Ty, class _Allocator, class mutex_Ty>
 inline std::size_t welp::cyclic_buffer_sync<Ty, _Allocator, mutex_Ty>::size() const noexcept
 {
@@ -12,12 +12,39 @@
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#include <chrono>
 #include <atomic>
-#include <functional>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <iterator>
+#include <new>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>
+#endif
+
+// thread pinning with pthread_setaffinity_np, disabled with #define WELP_THREADS_NO_AFFINITY
+#if defined(__linux__) && defined(_GNU_SOURCE) && !defined(WELP_THREADS_NO_AFFINITY)
+#define WELP_THREADS_LINUX_AFFINITY
+#include <cstdio>
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 
 // include all in one line with #define WELP_THREADS_INCLUDE_ALL
+// co_await T.schedule() and co_await on an async_task_result need C++20 coroutines
+#if defined(__cpp_impl_coroutine) && defined(__has_include) && !defined(WELP_THREADS_NO_COROUTINES)
+#if __has_include(<coroutine>)
+#include <coroutine>
+#define WELP_THREADS_COROUTINES
+#endif
+#endif
+
 #if defined(WELP_THREADS_INCLUDE_ALL) || defined(WELP_ALWAYS_INCLUDE_ALL)
 #ifndef WELP_THREADS_INCLUDE_FSTREAM
 #define WELP_THREADS_INCLUDE_FSTREAM
@@ -40,6 +67,24 @@
 #define WELP_THREADS_RECORD_INT unsigned int
 #endif // WELP_THREADS_RECORD_INT
 
+#ifndef WELP_THREADS_MAX_PRIORITY_LEVELS
+#define WELP_THREADS_MAX_PRIORITY_LEVELS 16
+#endif // WELP_THREADS_MAX_PRIORITY_LEVELS
+
+// number of buckets of the histogram of the time spent by tasks in the queue
+#ifndef WELP_THREADS_HISTOGRAM_SIZE
+#define WELP_THREADS_HISTOGRAM_SIZE 24
+#endif // WELP_THREADS_HISTOGRAM_SIZE
+
+// minimal number of elements per task of parallel_reduce, parallel_transform_reduce and parallel_inclusive_scan
+#ifndef WELP_THREADS_REDUCE_GRAIN
+#define WELP_THREADS_REDUCE_GRAIN 4096
+#endif // WELP_THREADS_REDUCE_GRAIN
+
+#ifndef WELP_THREADS_MAX_CPUS
+#define WELP_THREADS_MAX_CPUS 256
+#endif // WELP_THREADS_MAX_CPUS
+
 
 ////// DESCRIPTIONS //////
 
@@ -57,49 +102,206 @@ namespace welp
 		inline void deallocate(char* ptr, std::size_t) const noexcept { std::free(static_cast<void*>(ptr)); }
 	};
 
-	class async_task_end
+	// wait policies, wait_until(address, ready) returns once ready() is true
+	// and notify_all(address) is called after every change that can make ready() true
+
+	// spins without pause, for latency-critical waits
+	class threads_spin_wait
+	{
+
+	public:
+
+		template <class predicate_Ty> static inline void wait_until(const void*, predicate_Ty&& ready) noexcept
+		{
+			while (!ready()) {}
+		}
+		static inline void notify_all(const void*) noexcept {}
+	};
+
+	// spins with pause instructions, then yields, then parks the thread on a mutex and a condition variable
+	// picked by hashing the address waited on, notify_all only locks the mutex if a thread is parked
+	class threads_adaptive_wait
+	{
+
+	public:
+
+		static constexpr std::size_t spin_count = 64;
+		static constexpr std::size_t yield_count = 16;
+
+		template <class predicate_Ty> static inline void wait_until(const void* address, predicate_Ty&& ready) noexcept;
+		static inline void notify_all(const void* address) noexcept;
+
+	private:
+
+		class parking_slot
+		{
+
+		public:
+
+			std::mutex m_mutex;
+			std::condition_variable m_condition_var;
+			std::atomic<std::size_t> m_parked_threads{ 0 };
+			std::size_t m_padding[8] = { 0 };
+		};
+
+		static inline parking_slot& parking_slot_sub(const void* address) noexcept
+		{
+			static parking_slot parking_slots[64];
+			return parking_slots[(reinterpret_cast<std::uintptr_t>(address) / sizeof(void*)) % 64];
+		}
+		static inline void pause_sub() noexcept
+		{
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+			_mm_pause();
+#elif defined(__i386__) || defined(__x86_64__)
+			__builtin_ia32_pause();
+#elif defined(__aarch64__)
+			asm volatile("yield");
+#endif
+		}
+	};
+
+	// placement of the threads of a welp::threads, thread k is pinned to slot k % size()
+	// CPUs and NUMA nodes are detected and threads are pinned on Linux only, elsewhere the slots are only used to count threads
+	class threads_affinity
+	{
+
+	public:
+
+		// one slot per CPU available to the process, sorted by NUMA node
+		static inline welp::threads_affinity all_cpus() noexcept;
+		// one slot per physical core, the other hardware threads of the core are left out
+		static inline welp::threads_affinity physical_cores() noexcept;
+		// one slot per NUMA node, a thread may run on any CPU of its node
+		static inline welp::threads_affinity numa_nodes() noexcept;
+
+		inline bool add_cpu(int cpu) noexcept;
+		inline welp::threads_affinity& node_queues(bool enable) noexcept;
+
+		inline std::size_t size() const noexcept { return m_number_of_slots; }
+		inline bool empty() const noexcept { return m_number_of_slots == 0; }
+		inline std::size_t number_of_nodes() const noexcept { return m_number_of_nodes; }
+
+		threads_affinity() = default;
+
+	private:
+
+		template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> friend class threads;
+
+		// slot cpu is -1 for a slot spanning a whole node, nodes are numbered from 0 without gaps
+		int m_slot_cpus[WELP_THREADS_MAX_CPUS] = { 0 };
+		std::size_t m_slot_nodes[WELP_THREADS_MAX_CPUS] = { 0 };
+		std::size_t m_number_of_slots = 0;
+
+		// node of every CPU, -1 if the CPU is not available to the process
+		int m_cpu_nodes[WELP_THREADS_MAX_CPUS] = { 0 };
+		std::size_t m_number_of_nodes = 0;
+		bool m_topology_detected = false;
+		bool m_node_queues = false;
+
+		inline void detect_topology_sub() noexcept;
+		static inline bool read_cpu_list_sub(const char* path, bool* cpus_ptr) noexcept;
+	};
+
+	// continuations registered with then() form a list that the task of the box launches when it finishes
+	class threads_continuation
+	{
+
+	public:
+
+		void (*m_launch_ptr)(welp::threads_continuation*, const void*) = nullptr;
+		welp::threads_continuation* m_next_ptr = nullptr;
+
+		// if set, called instead of m_launch_ptr once the box is released, used to resume a coroutine awaiting the box
+		void (*m_resume_ptr)(welp::threads_continuation*) = nullptr;
+
+		// marks a box whose task is finished, continuations registered on it are launched immediately
+		static inline welp::threads_continuation* finished() noexcept
+		{
+			static welp::threads_continuation finished_continuation;
+			return &finished_continuation;
+		}
+
+		// marks a box that holds no task, because none was accepted since it was created or reset, continuations are refused
+		static inline welp::threads_continuation* unbound() noexcept
+		{
+			static welp::threads_continuation unbound_continuation;
+			return &unbound_continuation;
+		}
+	};
+
+	template <class wait_Ty = welp::threads_adaptive_wait> class basic_async_task_end
 	{
 
 	public:
 
-		template <class _Allocator> friend class threads;
+		template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class threads_wait_Ty> friend class threads;
 
 		inline void finish_task() const noexcept;
 
 		inline bool task_running() const noexcept;
 		inline bool task_denied() const noexcept;
+		inline bool task_cancelled() const noexcept;
 
 		void reset();
 
-		async_task_end() = default;
-		~async_task_end();
+		basic_async_task_end() = default;
+		~basic_async_task_end();
 
 	private:
 
 		std::atomic<bool> m_task_running{ false };
 		std::atomic<bool> m_task_denied{ false };
+		std::atomic<bool> m_task_cancelled{ false };
 
-		async_task_end(const welp::async_task_end& rhs) = delete;
-		welp::async_task_end& operator=(const welp::async_task_end& rhs) = delete;
-		async_task_end(welp::async_task_end&& rhs) = delete;
-		welp::async_task_end& operator=(welp::async_task_end&& rhs) = delete;
+		basic_async_task_end(const welp::basic_async_task_end<wait_Ty>& rhs) = delete;
+		welp::basic_async_task_end<wait_Ty>& operator=(const welp::basic_async_task_end<wait_Ty>& rhs) = delete;
+		basic_async_task_end(welp::basic_async_task_end<wait_Ty>&& rhs) = delete;
+		welp::basic_async_task_end<wait_Ty>& operator=(welp::basic_async_task_end<wait_Ty>&& rhs) = delete;
 	};
 
-	template <class Ty> class async_task_result
+	using async_task_end = welp::basic_async_task_end<welp::threads_adaptive_wait>;
+
+	template <class Ty, class wait_Ty = welp::threads_adaptive_wait> class async_task_result
 	{
 
 	public:
 
-		template <class _Allocator> friend class threads;
+		template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class threads_wait_Ty> friend class threads;
 
 		inline const Ty& get() const noexcept;
 		inline Ty& get() noexcept;
 
 		inline bool task_running() const noexcept;
 		inline bool task_denied() const noexcept;
+		inline bool task_cancelled() const noexcept;
 
 		void reset();
 
+#ifdef WELP_THREADS_COROUTINES
+		// co_await R resumes the coroutine on the thread finishing the task of R, and returns R.get()
+		class awaiter : public welp::threads_continuation
+		{
+
+		public:
+
+			inline bool await_ready() const noexcept { return !m_box_ptr->m_task_running.load(std::memory_order_acquire); }
+			inline bool await_suspend(std::coroutine_handle<> handle) noexcept;
+			inline Ty& await_resume() const noexcept { return m_box_ptr->m_stored_value; }
+
+			explicit awaiter(welp::async_task_result<Ty, wait_Ty>& box) noexcept : m_box_ptr(&box) { m_resume_ptr = &resume_sub; }
+
+		private:
+
+			welp::async_task_result<Ty, wait_Ty>* m_box_ptr;
+			std::coroutine_handle<> m_handle;
+
+			static void resume_sub(welp::threads_continuation* continuation_ptr) { static_cast<awaiter*>(continuation_ptr)->m_handle.resume(); }
+		};
+
+		inline awaiter operator co_await() noexcept { return awaiter(*this); }
+#endif // WELP_THREADS_COROUTINES
+
 		async_task_result() = default;
 		~async_task_result();
 
@@ -108,47 +310,317 @@ namespace welp
 		Ty m_stored_value = Ty();
 		std::atomic<bool> m_task_running{ false };
 		std::atomic<bool> m_task_denied{ false };
+		std::atomic<bool> m_task_cancelled{ false };
+		std::atomic<welp::threads_continuation*> m_continuation_ptr{ welp::threads_continuation::unbound() };
+
+		async_task_result(const welp::async_task_result<Ty, wait_Ty>& rhs) = delete;
+		welp::async_task_result<Ty, wait_Ty>& operator=(const welp::async_task_result<Ty, wait_Ty>& rhs) = delete;
+		async_task_result(welp::async_task_result<Ty, wait_Ty>&& rhs) = delete;
+		welp::async_task_result<Ty, wait_Ty>& operator=(welp::async_task_result<Ty, wait_Ty>&& rhs) = delete;
+	};
+
+	// countdown latch that any number of tasks can be attached to
+	template <class wait_Ty = welp::threads_adaptive_wait> class basic_task_group
+	{
+
+	public:
+
+		inline void wait() const noexcept;
+		inline bool try_wait() const noexcept;
+		inline bool is_done() const noexcept;
+		inline std::size_t count() const noexcept;
+
+		inline void add_count(std::size_t number_of_tasks) noexcept;
+		inline void count_down() noexcept;
+
+		basic_task_group() = default;
+		~basic_task_group();
+
+	private:
+
+		std::atomic<std::size_t> m_count{ 0 };
+
+		basic_task_group(const welp::basic_task_group<wait_Ty>& rhs) = delete;
+		welp::basic_task_group<wait_Ty>& operator=(const welp::basic_task_group<wait_Ty>& rhs) = delete;
+		basic_task_group(welp::basic_task_group<wait_Ty>&& rhs) = delete;
+		welp::basic_task_group<wait_Ty>& operator=(welp::basic_task_group<wait_Ty>&& rhs) = delete;
+	};
+
+	using task_group = welp::basic_task_group<welp::threads_adaptive_wait>;
+
+	// box of a task queued with T.async_task_every(R, period, f, args...), the task is run every period until R.cancel()
+	template <class wait_Ty> class basic_recurring_task
+	{
+
+	public:
+
+		inline void cancel() noexcept;
+		inline bool task_scheduled() const noexcept;
+
+		basic_recurring_task() = default;
+		~basic_recurring_task() { cancel(); }
+
+	private:
+
+		template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class threads_wait_Ty> friend class threads;
+
+		// set by the pool, m_node_ptr is only valid while m_scheduled is true
+		void (*m_cancel_ptr)(void*, welp::basic_recurring_task<wait_Ty>*) = nullptr;
+		void* m_pool_ptr = nullptr;
+		void* m_node_ptr = nullptr;
+		std::atomic<bool> m_scheduled{ false };
+
+		basic_recurring_task(const welp::basic_recurring_task<wait_Ty>& rhs) = delete;
+		welp::basic_recurring_task<wait_Ty>& operator=(const welp::basic_recurring_task<wait_Ty>& rhs) = delete;
+		basic_recurring_task(welp::basic_recurring_task<wait_Ty>&& rhs) = delete;
+		welp::basic_recurring_task<wait_Ty>& operator=(welp::basic_recurring_task<wait_Ty>&& rhs) = delete;
+	};
+
+	using recurring_task = welp::basic_recurring_task<welp::threads_adaptive_wait>;
+
+	// counters of a welp::threads or of one of its threads, the counters only grow so that rates come from two snapshots
+	// busy_ns, idle_ns and wait_histogram are only recorded while telemetry is on
+	class threads_snapshot
+	{
+
+	public:
+
+		std::size_t number_of_threads = 0;
+		std::size_t waiting_tasks = 0;
+		std::size_t unfinished_tasks = 0;
+		std::size_t timed_tasks = 0;
+
+		std::uint64_t tasks_run = 0;
+		std::uint64_t steals = 0;
+		std::uint64_t busy_ns = 0;
+		std::uint64_t idle_ns = 0;
+
+		// time spent in the queue, bucket 0 is below 1024 ns, bucket k from 2^(9 + k) ns to 2^(10 + k) ns, the last bucket has no upper bound
+		std::uint64_t wait_histogram[WELP_THREADS_HISTOGRAM_SIZE] = { 0 };
+	};
+
+	// can be shared by any number of tasks queued with a welp::task_cancellation, and must outlive them
+	class cancellation_token
+	{
+
+	public:
+
+		inline void cancel() noexcept { m_cancelled.store(true, std::memory_order_release); }
+		inline bool cancelled() const noexcept { return m_cancelled.load(std::memory_order_acquire); }
+		inline void reset() noexcept { m_cancelled.store(false, std::memory_order_release); }
+
+		cancellation_token() = default;
+
+	private:
+
+		std::atomic<bool> m_cancelled{ false };
+
+		cancellation_token(const welp::cancellation_token& rhs) = delete;
+		welp::cancellation_token& operator=(const welp::cancellation_token& rhs) = delete;
+		cancellation_token(welp::cancellation_token&& rhs) = delete;
+		welp::cancellation_token& operator=(welp::cancellation_token&& rhs) = delete;
+	};
+
+	// a task queued with a welp::task_cancellation is dropped by the thread taking it
+	// if the token is cancelled or if the deadline is past by then
+	class task_cancellation
+	{
+
+	public:
 
-		async_task_result(const welp::async_task_result<Ty>& rhs) = delete;
-		welp::async_task_result<Ty>& operator=(const welp::async_task_result<Ty>& rhs) = delete;
-		async_task_result(welp::async_task_result<Ty>&& rhs) = delete;
-		welp::async_task_result<Ty>& operator=(welp::async_task_result<Ty>&& rhs) = delete;
+		explicit task_cancellation(const welp::cancellation_token& token) noexcept : m_token_ptr(&token) {}
+		template <class clock_Ty, class duration_Ty>
+		explicit task_cancellation(const std::chrono::time_point<clock_Ty, duration_Ty>& deadline) noexcept
+			: m_deadline(steady_deadline_sub(deadline)) {}
+		template <class clock_Ty, class duration_Ty>
+		task_cancellation(const welp::cancellation_token& token, const std::chrono::time_point<clock_Ty, duration_Ty>& deadline) noexcept
+			: m_token_ptr(&token), m_deadline(steady_deadline_sub(deadline)) {}
+
+		inline bool expired() const noexcept
+		{
+			return ((m_token_ptr != nullptr) && m_token_ptr->cancelled())
+				|| ((m_deadline != std::chrono::steady_clock::time_point::max()) && (std::chrono::steady_clock::now() >= m_deadline));
+		}
+
+	private:
+
+		const welp::cancellation_token* m_token_ptr = nullptr;
+		std::chrono::steady_clock::time_point m_deadline = std::chrono::steady_clock::time_point::max();
+
+		template <class clock_Ty, class duration_Ty>
+		static inline std::chrono::steady_clock::time_point steady_deadline_sub(const std::chrono::time_point<clock_Ty, duration_Ty>& deadline) noexcept
+		{
+			return std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(deadline - clock_Ty::now());
+		}
+	};
+
+	// what a welp::threads does with a task queued while its queue is full
+	// reject : the task is denied, run_inline : the calling thread runs the task,
+	// spill : the task goes to an unbounded list that the threads drain as the queue empties
+	enum class threads_overflow { reject, run_inline, spill };
+
+	// priority level of a task queued on a welp::threads, level 0 is dequeued first
+	class threads_priority
+	{
+
+	public:
+
+		explicit threads_priority(std::size_t level) noexcept : m_level(level) {}
+		inline std::size_t level() const noexcept { return m_level; }
+
+	private:
+
+		std::size_t m_level;
 	};
 
-	template <class _Allocator = welp::default_threads_allocator> class threads : private _Allocator
+	// work_stealing = false : every task goes through one shared lock-free queue
+	// work_stealing = true : every thread also owns a deque, tasks submitted from a thread of the pool
+	// are pushed and popped at the bottom of its own deque and idle threads steal from the top of the others
+	// task_cell_size : bytes stored in place for a task and copies of its arguments,
+	// bigger tasks are stored with _Allocator unless WELP_THREADS_FORBID_TASK_ALLOCATION is defined
+	// wait_Ty : wait policy of finish_all_tasks and of the force_ functions when the queue is full
+	template <class _Allocator = welp::default_threads_allocator, bool work_stealing = false,
+		std::size_t task_cell_size = 64, class wait_Ty = welp::threads_adaptive_wait> class threads : private _Allocator
 	{
 
 	public:
 
-		template <class function_Ty, class ... _Args> bool async_task(const function_Ty& task, _Args&& ... args);
-		template <class function_Ty, class ... _Args> void force_async_task(const function_Ty& task, _Args&& ... args);
-		template <class function_Ty, class ... _Args> bool priority_async_task(const function_Ty& task, _Args&& ... args);
-		template <class function_Ty, class ... _Args> void force_priority_async_task(const function_Ty& task, _Args&& ... args);
-
-		template <class function_Ty, class ... _Args> bool async_task(welp::async_task_end& box, const function_Ty& task, _Args&& ... args);
-		template <class function_Ty, class ... _Args> void force_async_task(welp::async_task_end& box, const function_Ty& task, _Args&& ... args);
-		template <class function_Ty, class ... _Args> bool priority_async_task(welp::async_task_end& box, const function_Ty& task, _Args&& ... args);
-		template <class function_Ty, class ... _Args> void force_priority_async_task(welp::async_task_end& box, const function_Ty& task, _Args&& ... args);
-
-		template <class return_Ty, class function_Ty, class ... _Args>
-		bool async_task(welp::async_task_result<return_Ty>& box, const function_Ty& task, _Args&& ... args);
-		template <class return_Ty, class function_Ty, class ... _Args>
-		void force_async_task(welp::async_task_result<return_Ty>& box, const function_Ty& task, _Args&& ... args);
-		template <class return_Ty, class function_Ty, class ... _Args>
-		bool priority_async_task(welp::async_task_result<return_Ty>& box, const function_Ty& task, _Args&& ... args);
-		template <class return_Ty, class function_Ty, class ... _Args>
-		void force_priority_async_task(welp::async_task_result<return_Ty>& box, const function_Ty& task, _Args&& ... args);
+		template <class function_Ty, class ... _Args> bool async_task(function_Ty&& task, _Args&& ... args);
+		template <class function_Ty, class ... _Args> void force_async_task(function_Ty&& task, _Args&& ... args);
+		template <class function_Ty, class ... _Args> bool priority_async_task(function_Ty&& task, _Args&& ... args);
+		template <class function_Ty, class ... _Args> void force_priority_async_task(function_Ty&& task, _Args&& ... args);
+
+		template <class box_wait_Ty, class function_Ty, class ... _Args> bool async_task(welp::basic_async_task_end<box_wait_Ty>& box, function_Ty&& task, _Args&& ... args);
+		template <class box_wait_Ty, class function_Ty, class ... _Args> void force_async_task(welp::basic_async_task_end<box_wait_Ty>& box, function_Ty&& task, _Args&& ... args);
+		template <class box_wait_Ty, class function_Ty, class ... _Args> bool priority_async_task(welp::basic_async_task_end<box_wait_Ty>& box, function_Ty&& task, _Args&& ... args);
+		template <class box_wait_Ty, class function_Ty, class ... _Args> void force_priority_async_task(welp::basic_async_task_end<box_wait_Ty>& box, function_Ty&& task, _Args&& ... args);
+
+		template <class return_Ty, class box_wait_Ty, class function_Ty, class ... _Args>
+		bool async_task(welp::async_task_result<return_Ty, box_wait_Ty>& box, function_Ty&& task, _Args&& ... args);
+		template <class return_Ty, class box_wait_Ty, class function_Ty, class ... _Args>
+		void force_async_task(welp::async_task_result<return_Ty, box_wait_Ty>& box, function_Ty&& task, _Args&& ... args);
+		template <class return_Ty, class box_wait_Ty, class function_Ty, class ... _Args>
+		bool priority_async_task(welp::async_task_result<return_Ty, box_wait_Ty>& box, function_Ty&& task, _Args&& ... args);
+		template <class return_Ty, class box_wait_Ty, class function_Ty, class ... _Args>
+		void force_priority_async_task(welp::async_task_result<return_Ty, box_wait_Ty>& box, function_Ty&& task, _Args&& ... args);
+
+		template <class group_wait_Ty, class function_Ty, class ... _Args> bool async_task(welp::basic_task_group<group_wait_Ty>& group, function_Ty&& task, _Args&& ... args);
+		template <class group_wait_Ty, class function_Ty, class ... _Args> void force_async_task(welp::basic_task_group<group_wait_Ty>& group, function_Ty&& task, _Args&& ... args);
+		template <class group_wait_Ty, class function_Ty, class ... _Args> bool priority_async_task(welp::basic_task_group<group_wait_Ty>& group, function_Ty&& task, _Args&& ... args);
+		template <class group_wait_Ty, class function_Ty, class ... _Args> void force_priority_async_task(welp::basic_task_group<group_wait_Ty>& group, function_Ty&& task, _Args&& ... args);
+
+		template <class function_Ty, class ... _Args> bool async_task(welp::threads_priority priority, function_Ty&& task, _Args&& ... args);
+		template <class function_Ty, class ... _Args> void force_async_task(welp::threads_priority priority, function_Ty&& task, _Args&& ... args);
+		template <class box_wait_Ty, class function_Ty, class ... _Args>
+		bool async_task(welp::threads_priority priority, welp::basic_async_task_end<box_wait_Ty>& box, function_Ty&& task, _Args&& ... args);
+		template <class box_wait_Ty, class function_Ty, class ... _Args>
+		void force_async_task(welp::threads_priority priority, welp::basic_async_task_end<box_wait_Ty>& box, function_Ty&& task, _Args&& ... args);
+		template <class return_Ty, class box_wait_Ty, class function_Ty, class ... _Args>
+		bool async_task(welp::threads_priority priority, welp::async_task_result<return_Ty, box_wait_Ty>& box, function_Ty&& task, _Args&& ... args);
+		template <class return_Ty, class box_wait_Ty, class function_Ty, class ... _Args>
+		void force_async_task(welp::threads_priority priority, welp::async_task_result<return_Ty, box_wait_Ty>& box, function_Ty&& task, _Args&& ... args);
+		template <class group_wait_Ty, class function_Ty, class ... _Args>
+		bool async_task(welp::threads_priority priority, welp::basic_task_group<group_wait_Ty>& group, function_Ty&& task, _Args&& ... args);
+		template <class group_wait_Ty, class function_Ty, class ... _Args>
+		void force_async_task(welp::threads_priority priority, welp::basic_task_group<group_wait_Ty>& group, function_Ty&& task, _Args&& ... args);
+
+		template <class function_Ty, class ... _Args> bool async_task(welp::task_cancellation cancellation, function_Ty&& task, _Args&& ... args);
+		template <class function_Ty, class ... _Args> void force_async_task(welp::task_cancellation cancellation, function_Ty&& task, _Args&& ... args);
+		template <class box_wait_Ty, class function_Ty, class ... _Args>
+		bool async_task(welp::task_cancellation cancellation, welp::basic_async_task_end<box_wait_Ty>& box, function_Ty&& task, _Args&& ... args);
+		template <class box_wait_Ty, class function_Ty, class ... _Args>
+		void force_async_task(welp::task_cancellation cancellation, welp::basic_async_task_end<box_wait_Ty>& box, function_Ty&& task, _Args&& ... args);
+		template <class return_Ty, class box_wait_Ty, class function_Ty, class ... _Args>
+		bool async_task(welp::task_cancellation cancellation, welp::async_task_result<return_Ty, box_wait_Ty>& box, function_Ty&& task, _Args&& ... args);
+		template <class return_Ty, class box_wait_Ty, class function_Ty, class ... _Args>
+		void force_async_task(welp::task_cancellation cancellation, welp::async_task_result<return_Ty, box_wait_Ty>& box, function_Ty&& task, _Args&& ... args);
+		template <class group_wait_Ty, class function_Ty, class ... _Args>
+		bool async_task(welp::task_cancellation cancellation, welp::basic_task_group<group_wait_Ty>& group, function_Ty&& task, _Args&& ... args);
+		template <class group_wait_Ty, class function_Ty, class ... _Args>
+		void force_async_task(welp::task_cancellation cancellation, welp::basic_task_group<group_wait_Ty>& group, function_Ty&& task, _Args&& ... args);
+
+		template <class clock_Ty, class duration_Ty, class function_Ty, class ... _Args>
+		bool async_task_at(const std::chrono::time_point<clock_Ty, duration_Ty>& time_point, function_Ty&& task, _Args&& ... args);
+		template <class rep_Ty, class period_Ty, class function_Ty, class ... _Args>
+		bool async_task_after(const std::chrono::duration<rep_Ty, period_Ty>& delay, function_Ty&& task, _Args&& ... args);
+		template <class box_wait_Ty, class rep_Ty, class period_Ty, class function_Ty, class ... _Args>
+		bool async_task_every(welp::basic_recurring_task<box_wait_Ty>& box, const std::chrono::duration<rep_Ty, period_Ty>& period, function_Ty&& task, _Args&& ... args);
+		inline std::size_t timed_task_count() const noexcept;
+
+		template <class rep_Ty, class period_Ty, class function_Ty, class ... _Args>
+		bool try_async_task_for(const std::chrono::duration<rep_Ty, period_Ty>& timeout, function_Ty&& task, _Args&& ... args);
+		template <class rep_Ty, class period_Ty, class function_Ty, class ... _Args>
+		bool try_async_task_for(welp::threads_priority priority, const std::chrono::duration<rep_Ty, period_Ty>& timeout, function_Ty&& task, _Args&& ... args);
+		bool set_overflow_policy(welp::threads_overflow policy) noexcept;
+		inline std::size_t spilled_task_count() const noexcept;
+
+		void set_telemetry(bool enable) noexcept;
+		welp::threads_snapshot snapshot() const noexcept;
+		welp::threads_snapshot snapshot(std::size_t thread_number) const noexcept;
+
+#ifdef WELP_THREADS_COROUTINES
+		// co_await T.schedule() resumes the coroutine on a thread of T, and returns false if the queue was full
+		// in which case the coroutine goes on in the calling thread
+		class schedule_awaiter
+		{
+
+		public:
+
+			inline bool await_ready() const noexcept { return false; }
+			inline bool await_suspend(std::coroutine_handle<> handle) noexcept;
+			inline bool await_resume() const noexcept { return m_scheduled; }
+
+			schedule_awaiter(welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>* pool_ptr, std::size_t level) noexcept
+				: m_pool_ptr(pool_ptr), m_level(level) {}
+
+		private:
+
+			welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>* m_pool_ptr;
+			std::size_t m_level;
+			bool m_scheduled = false;
+		};
+
+		inline schedule_awaiter schedule() noexcept;
+		inline schedule_awaiter schedule(welp::threads_priority priority) noexcept;
+#endif // WELP_THREADS_COROUTINES
+
+		template <class value_Ty, class value_wait_Ty, class function_Ty>
+		bool then(welp::async_task_result<value_Ty, value_wait_Ty>& box, function_Ty&& task);
+		template <class value_Ty, class value_wait_Ty, class box_wait_Ty, class function_Ty>
+		bool then(welp::async_task_result<value_Ty, value_wait_Ty>& box, welp::basic_async_task_end<box_wait_Ty>& next_box, function_Ty&& task);
+		template <class value_Ty, class value_wait_Ty, class return_Ty, class box_wait_Ty, class function_Ty>
+		bool then(welp::async_task_result<value_Ty, value_wait_Ty>& box, welp::async_task_result<return_Ty, box_wait_Ty>& next_box, function_Ty&& task);
+		template <class value_Ty, class value_wait_Ty, class group_wait_Ty, class function_Ty>
+		bool then(welp::async_task_result<value_Ty, value_wait_Ty>& box, welp::basic_task_group<group_wait_Ty>& group, function_Ty&& task);
+
+		template <class iterator_Ty, class function_Ty> bool async_batch(iterator_Ty first, iterator_Ty last, function_Ty&& task);
+		template <class box_wait_Ty, class iterator_Ty, class function_Ty>
+		bool async_batch(welp::basic_async_task_end<box_wait_Ty>& box, iterator_Ty first, iterator_Ty last, function_Ty&& task);
+		template <class index_Ty, class function_Ty> void parallel_for(index_Ty begin, index_Ty end, index_Ty grain, function_Ty&& task);
+		template <class iterator_Ty, class value_Ty, class reduce_Ty>
+		value_Ty parallel_reduce(iterator_Ty first, iterator_Ty last, value_Ty init, reduce_Ty&& reduce);
+		template <class iterator_Ty, class value_Ty, class reduce_Ty, class transform_Ty>
+		value_Ty parallel_transform_reduce(iterator_Ty first, iterator_Ty last, value_Ty init, reduce_Ty&& reduce, transform_Ty&& transform);
+		template <class input_iterator_Ty, class output_iterator_Ty, class op_Ty>
+		output_iterator_Ty parallel_inclusive_scan(input_iterator_Ty first, input_iterator_Ty last, output_iterator_Ty output, op_Ty&& op);
 
 		void finish_all_tasks() noexcept;
 		inline std::size_t waiting_task_count() const noexcept;
+		inline std::size_t waiting_task_count(std::size_t level) const noexcept;
 		inline std::size_t unfinished_task_count() const noexcept;
 
 		inline bool owns_resources() const noexcept;
 		inline std::size_t number_of_threads() const noexcept;
 		inline std::size_t task_buffer_size() const noexcept;
+		inline std::size_t number_of_priority_levels() const noexcept;
 
+		bool set_priority_levels(std::size_t number_of_levels, const std::size_t* weights_ptr = nullptr) noexcept;
+		bool set_thread_limits(std::size_t min_number_of_threads, std::size_t max_number_of_threads, std::chrono::milliseconds idle_time) noexcept;
 		bool new_threads(std::size_t input_number_of_threads, std::size_t input_task_buffer_size);
+		bool new_threads(std::size_t input_number_of_threads, std::size_t input_task_buffer_size, const welp::threads_affinity& affinity);
 		void delete_threads() noexcept;
+		std::size_t add_threads(std::size_t number_of_new_threads);
+		std::size_t retire_threads(std::size_t number_of_retired_threads);
 
 #ifdef WELP_THREADS_DEBUG_MODE
 		void DEBUG_start_record() noexcept { std::lock_guard<std::mutex> resource_lock(m_mutex); m_DEBUG_record_on = true; };
@@ -178,1353 +650,4574 @@ namespace welp
 #endif // WELP_THREADS_INCLUDE_FSTREAM
 #endif // WELP_THREADS_DEBUG_MODE
 
+		using allocator_type = _Allocator;
+		using wait_type = wait_Ty;
+
 		threads() = default;
 		virtual ~threads() { delete_threads(); }
 
 	private:
 
-		std::condition_variable m_condition_var;
-		mutable std::mutex m_mutex;
+		template <class threads_Ty> friend class task_graph;
 
-		std::thread* m_threads_data_ptr = nullptr;
-		std::size_t m_number_of_threads = 0;
+		// type-erased task stored in place, or with _Allocator if it does not fit in task_cell_size bytes
+		class task_cell
+		{
 
-		std::function<void()>* m_task_buffer_data_ptr = nullptr;
-		std::function<void()>* m_task_buffer_end_ptr = static_cast<std::function<void()>*>(nullptr) + 1;
+		public:
 
-		std::function<void()>* m_last_task_ptr = nullptr;
-		std::function<void()>* m_next_task_ptr = static_cast<std::function<void()>*>(nullptr) + 1;
+			template <class callable_Ty> inline void store(callable_Ty&& callable, _Allocator& allocator);
+			inline void run();
+			inline void invoke();
+			inline void relocate_to(task_cell& destination) noexcept;
+			inline void clear() noexcept;
+			inline bool empty() const noexcept { return m_invoke_ptr == nullptr; }
 
-		std::atomic<std::size_t> m_waiting_tasks{ 0 };
-		std::atomic<std::size_t> m_unfinished_tasks{ 0 };
+#ifndef WELP_THREADS_NO_TELEMETRY
+			// steady clock in ns when the task was queued, only recorded while telemetry is on
+			std::int64_t m_queued_time = 0;
+#endif // WELP_THREADS_NO_TELEMETRY
 
-		std::atomic<bool> m_waiting_for_finish{ false };
-		bool m_stop_threads = true;
+			task_cell() = default;
+			~task_cell() { clear(); }
 
-		threads(const welp::threads<_Allocator>&) = delete;
-		welp::threads<_Allocator>& operator=(const welp::threads<_Allocator>&) = delete;
-		threads(welp::threads<_Allocator>&&) = delete;
-		welp::threads<_Allocator>& operator=(welp::threads<_Allocator>&&) = delete;
+		private:
 
+			class heap_task
+			{
 
-		template <class function_Ty, class ... _Args> bool force_async_task_sub(const function_Ty& task, _Args&& ... args);
-		template <class function_Ty, class ... _Args> bool force_priority_async_task_sub(const function_Ty& task, _Args&& ... args);
+			public:
 
-		template <class function_Ty, class ... _Args> bool force_async_task_sub(welp::async_task_end& box, const function_Ty& task, _Args&& ... args);
-		template <class function_Ty, class ... _Args> bool force_priority_async_task_sub(welp::async_task_end& box, const function_Ty& task, _Args&& ... args);
+				void* task_ptr;
+				_Allocator* allocator_ptr;
+			};
 
-		template <class return_Ty, class function_Ty, class ... _Args>
-		bool force_async_task_sub(welp::async_task_result<return_Ty>& box, const function_Ty& task, _Args&& ... args);
-		template <class return_Ty, class function_Ty, class ... _Args>
-		bool force_priority_async_task_sub(welp::async_task_result<return_Ty>& box, const function_Ty& task, _Args&& ... args);
+			static_assert(task_cell_size >= sizeof(heap_task), "welp::threads : task_cell_size is too small");
+
+			alignas(std::max_align_t) unsigned char m_storage[task_cell_size];
+			void (*m_invoke_ptr)(unsigned char*) = nullptr;
+			// relocates to destination_ptr if it is not a nullptr, destroys otherwise
+			void (*m_manage_ptr)(unsigned char*, unsigned char*) = nullptr;
+
+			template <class callable_Ty> inline void store_sub(callable_Ty&& callable, _Allocator& allocator, std::true_type);
+			template <class callable_Ty> inline void store_sub(callable_Ty&& callable, _Allocator& allocator, std::false_type);
+			template <class callable_Ty> static void invoke_inline_sub(unsigned char* storage_ptr);
+			template <class callable_Ty> static void manage_inline_sub(unsigned char* storage_ptr, unsigned char* destination_ptr) noexcept;
+			template <class callable_Ty> static void invoke_heap_sub(unsigned char* storage_ptr);
+			template <class callable_Ty> static void manage_heap_sub(unsigned char* storage_ptr, unsigned char* destination_ptr) noexcept;
+
+			task_cell(const task_cell&) = delete;
+			task_cell& operator=(const task_cell&) = delete;
+			task_cell(task_cell&&) = delete;
+			task_cell& operator=(task_cell&&) = delete;
+		};
+
+		template <std::size_t ... indices> class index_list {};
+		template <std::size_t count, std::size_t ... indices> class make_index_list
+			: public make_index_list<count - 1, count - 1, indices...> {};
+		template <std::size_t ... indices> class make_index_list<0, indices...>
+		{
 
-#ifdef WELP_THREADS_DEBUG_MODE
-		std::atomic<WELP_THREADS_RECORD_INT> m_DEBUG_record_max_occupancy{ 0 };
-		std::atomic<WELP_THREADS_RECORD_INT> m_DEBUG_record_completed_task_count{ 0 };
-		WELP_THREADS_RECORD_INT m_DEBUG_record_accepted_task_count = 0;
-		std::atomic<WELP_THREADS_RECORD_INT> m_DEBUG_record_denied_task_count{ 0 };
-		std::atomic<WELP_THREADS_RECORD_INT> m_DEBUG_record_delayed_task_count{ 0 };
-		bool m_DEBUG_record_on = false;
+		public:
 
-		void DEBUG_say_sub();
-		void DEBUG_write_sub(std::ofstream& rec_write);
-#endif // WELP_THREADS_DEBUG_MODE
-	};
-}
+			using type = index_list<indices...>;
+		};
 
+		// decayed copies of the task and of its arguments, the arguments are moved into the task when it runs
+		template <class function_Ty, class ... _Args> class bound_task
+		{
 
-////// IMPLEMENTATIONS //////
+		public:
 
-inline void welp::async_task_end::finish_task() const noexcept
-{
-	while (m_task_running.load(std::memory_order_acquire)) {}
-}
+			using return_type = decltype(std::declval<function_Ty&>()(std::declval<_Args>()...));
 
-inline bool welp::async_task_end::task_running() const noexcept
-{
-	return m_task_running.load(std::memory_order_acquire);
-}
-inline bool welp::async_task_end::task_denied() const noexcept
-{
-	return m_task_denied.load(std::memory_order_acquire);
-}
+			template <class fwd_function_Ty, class ... fwd_Args> bound_task(fwd_function_Ty&& task, fwd_Args&& ... args)
+				: m_task(std::forward<fwd_function_Ty>(task)), m_args(std::forward<fwd_Args>(args)...) {}
 
-void welp::async_task_end::reset()
-{
-	while (m_task_running.load(std::memory_order_acquire)) {}
-	m_task_running.store(false, std::memory_order_release);
-	m_task_denied.store(false, std::memory_order_release);
-}
+			inline return_type operator()() { return call_sub(typename make_index_list<sizeof...(_Args)>::type()); }
 
-welp::async_task_end::~async_task_end()
-{
-	while (m_task_running.load(std::memory_order_acquire)) {}
-}
+		private:
 
+			function_Ty m_task;
+			std::tuple<_Args...> m_args;
 
-template <class Ty> inline const Ty& welp::async_task_result<Ty>::get() const noexcept
-{
-	while (m_task_running.load(std::memory_order_acquire)) {}
-	return m_stored_value;
-}
-template <class Ty> inline Ty& welp::async_task_result<Ty>::get() noexcept
-{
-	while (m_task_running.load(std::memory_order_acquire)) {}
-	return m_stored_value;
-}
+			template <std::size_t ... indices> inline return_type call_sub(index_list<indices...>)
+			{
+				return m_task(std::move(std::get<indices>(m_args))...);
+			}
+		};
 
-template <class Ty> inline bool welp::async_task_result<Ty>::task_running() const noexcept
-{
-	return m_task_running.load(std::memory_order_release);
-}
-template <class Ty> inline bool welp::async_task_result<Ty>::task_denied() const noexcept
-{
-	return m_task_denied.load(std::memory_order_release);
-}
+		// checks the cancellation when a thread takes the task, a dropped task marks its box if any and returns return_Ty()
+		template <class function_Ty, class return_Ty> class cancellable_task
+		{
 
-template <class Ty> void welp::async_task_result<Ty>::reset()
-{
-	while (m_task_running.load(std::memory_order_acquire)) {}
-	m_stored_value = Ty();
-	m_task_running.store(false, std::memory_order_release);
-	m_task_denied.store(false, std::memory_order_release);
-}
+		public:
 
-template <class Ty> welp::async_task_result<Ty>::~async_task_result()
-{
-	while (m_task_running.load(std::memory_order_acquire)) {}
-}
+			template <class fwd_function_Ty> cancellable_task(fwd_function_Ty&& task, const welp::task_cancellation& cancellation, std::atomic<bool>* cancelled_ptr)
+				: m_task(std::forward<fwd_function_Ty>(task)), m_cancellation(cancellation), m_cancelled_ptr(cancelled_ptr) {}
+
+			template <class ... _Args> inline return_Ty operator()(_Args&& ... args)
+			{
+				if (m_cancellation.expired())
+				{
+					if (m_cancelled_ptr != nullptr)
+					{
+						m_cancelled_ptr->store(true, std::memory_order_release);
+					}
+					return return_Ty();
+				}
+				return static_cast<return_Ty>(m_task(std::forward<_Args>(args)...));
+			}
 
+		private:
 
-template <class _Allocator> template <class function_Ty, class ... _Args>
-bool welp::threads<_Allocator>::async_task(const function_Ty& task, _Args&& ... args)
-{
-	while (m_waiting_for_finish.load(std::memory_order_relaxed)) {}
-	std::unique_lock<std::mutex> lock(m_mutex);
+			function_Ty m_task;
+			welp::task_cancellation m_cancellation;
+			std::atomic<bool>* m_cancelled_ptr;
+		};
 
-	if ((m_last_task_ptr + 1 != m_next_task_ptr) &&
-		((m_next_task_ptr != m_task_buffer_data_ptr) || (m_last_task_ptr + 1 != m_task_buffer_end_ptr)))
-	{
-		m_waiting_tasks.fetch_add(1, std::memory_order_acquire);
-		m_unfinished_tasks.fetch_add(1, std::memory_order_acquire);
+		template <class function_Ty, class return_Ty> using cancellable_task_type = cancellable_task<typename std::decay<function_Ty>::type, return_Ty>;
 
-		try
-		{
-			*m_last_task_ptr = [&]()
-			{
-				task(std::forward<_Args>(args)...);
-			};
-		}
-		catch (...)
+		// stands for a task that could not be stored, so that its box is released like after a dropped task
+		template <class return_Ty> class denied_task
 		{
-			m_waiting_tasks.fetch_sub(1, std::memory_order_release);
-			m_unfinished_tasks.fetch_sub(1, std::memory_order_release);
 
-#ifdef WELP_THREADS_DEBUG_MODE
-			if (m_DEBUG_record_on)
-			{
-				m_DEBUG_record_denied_task_count.fetch_add(1);
-			}
-#endif // WELP_THREADS_DEBUG_MODE
+		public:
 
-			return false;
-		}
+			inline return_Ty operator()() const { return return_Ty(); }
+		};
 
-		m_last_task_ptr++;
-		if (m_last_task_ptr == m_task_buffer_end_ptr)
+		// the box can be destroyed as soon as m_task_running is false, the notification only uses its address
+		template <class box_wait_Ty, class bound_Ty> class end_box_task
 		{
-			m_last_task_ptr = m_task_buffer_data_ptr;
-		}
 
-		m_condition_var.notify_one();
+		public:
 
-#ifdef WELP_THREADS_DEBUG_MODE
-		if (m_DEBUG_record_on)
-		{
-			m_DEBUG_record_accepted_task_count++;
-			std::size_t temp = m_waiting_tasks.load();
-			if (temp > m_DEBUG_record_max_occupancy.load())
+			end_box_task(bound_Ty&& bound, welp::basic_async_task_end<box_wait_Ty>& box) : m_bound(std::move(bound)), m_box_ptr(&box) {}
+
+			inline void operator()()
 			{
-				m_DEBUG_record_max_occupancy.store(temp);
+				m_bound();
+				const void* address = &m_box_ptr->m_task_running;
+				m_box_ptr->m_task_running.store(false, std::memory_order_release);
+				box_wait_Ty::notify_all(address);
 			}
-		}
-#endif // WELP_THREADS_DEBUG_MODE
 
-		return true;
-	}
-	else
-	{
-#ifdef WELP_THREADS_DEBUG_MODE
-		if (m_DEBUG_record_on)
+		private:
+
+			bound_Ty m_bound;
+			welp::basic_async_task_end<box_wait_Ty>* m_box_ptr;
+		};
+
+		template <class return_Ty, class box_wait_Ty, class bound_Ty> class result_box_task
 		{
-			m_DEBUG_record_denied_task_count.fetch_add(1);
-		}
-#endif // WELP_THREADS_DEBUG_MODE
 
-		return false;
-	}
-}
+		public:
 
-template <class _Allocator> template <class function_Ty, class ... _Args>
-void welp::threads<_Allocator>::force_async_task(const function_Ty& task, _Args&& ... args)
-{
+			result_box_task(bound_Ty&& bound, welp::async_task_result<return_Ty, box_wait_Ty>& box) : m_bound(std::move(bound)), m_box_ptr(&box) {}
 
-#ifdef WELP_THREADS_DEBUG_MODE
-	if (!force_async_task_sub(task, std::forward<_Args>(args)...))
-	{
-		m_DEBUG_record_delayed_task_count.fetch_add(1);
-	}
+			inline void operator()()
+			{
+				m_box_ptr->m_stored_value = m_bound();
+				welp::threads_continuation* continuation_ptr
+					= m_box_ptr->m_continuation_ptr.exchange(welp::threads_continuation::finished(), std::memory_order_acq_rel);
+				welp::threads_continuation* resume_ptr = nullptr;
+				while (continuation_ptr != nullptr)
+				{
+					welp::threads_continuation* next_ptr = continuation_ptr->m_next_ptr;
+					if (continuation_ptr->m_resume_ptr != nullptr)
+					{
+						continuation_ptr->m_next_ptr = resume_ptr;
+						resume_ptr = continuation_ptr;
+					}
+					else
+					{
+						continuation_ptr->m_launch_ptr(continuation_ptr, &m_box_ptr->m_stored_value);
+					}
+					continuation_ptr = next_ptr;
+				}
+				const void* address = &m_box_ptr->m_task_running;
+				m_box_ptr->m_task_running.store(false, std::memory_order_release);
+				box_wait_Ty::notify_all(address);
+
+				// a resumed coroutine may destroy the box, so it is only resumed once the box is released
+				while (resume_ptr != nullptr)
+				{
+					welp::threads_continuation* next_ptr = resume_ptr->m_next_ptr;
+					resume_ptr->m_resume_ptr(resume_ptr);
+					resume_ptr = next_ptr;
+				}
+			}
+
+		private:
+
+			bound_Ty m_bound;
+			welp::async_task_result<return_Ty, box_wait_Ty>* m_box_ptr;
+		};
+
+		template <class group_wait_Ty, class bound_Ty> class group_task
+		{
+
+		public:
+
+			group_task(bound_Ty&& bound, welp::basic_task_group<group_wait_Ty>& group) : m_bound(std::move(bound)), m_group_ptr(&group) {}
+
+			inline void operator()()
+			{
+				m_bound();
+				m_group_ptr->count_down();
+			}
+
+		private:
+
+			bound_Ty m_bound;
+			welp::basic_task_group<group_wait_Ty>* m_group_ptr;
+		};
+
+		template <class function_Ty, class ... _Args> using bound_task_type
+			= bound_task<typename std::decay<function_Ty>::type, typename std::decay<_Args>::type...>;
+
+		// the arguments are passed as lvalues since the task runs again and again
+		template <class function_Ty, class ... _Args> class repeated_task
+		{
+
+		public:
+
+			template <class fwd_function_Ty, class ... fwd_Args> repeated_task(fwd_function_Ty&& task, fwd_Args&& ... args)
+				: m_task(std::forward<fwd_function_Ty>(task)), m_args(std::forward<fwd_Args>(args)...) {}
+
+			inline void operator()() { call_sub(typename make_index_list<sizeof...(_Args)>::type()); }
+
+		private:
+
+			function_Ty m_task;
+			std::tuple<_Args...> m_args;
+
+			template <std::size_t ... indices> inline void call_sub(index_list<indices...>)
+			{
+				m_task(std::get<indices>(m_args)...);
+			}
+		};
+
+		template <class function_Ty, class ... _Args> using repeated_task_type
+			= repeated_task<typename std::decay<function_Ty>::type, typename std::decay<_Args>::type...>;
+
+		// stored with _Allocator in the timer heap of the pool until its deadline, then queued through a timed_task
+		class timed_node
+		{
+
+		public:
+
+			task_cell m_task;
+			std::chrono::steady_clock::time_point m_deadline;
+			std::chrono::steady_clock::duration m_period{ 0 };
+			void* m_box_ptr = nullptr;
+			void (*m_finish_ptr)(void*) = nullptr;
+			bool m_cancelled = false;
+		};
+
+		class timed_task
+		{
+
+		public:
+
+			timed_task(welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>* pool_ptr, timed_node* node_ptr) noexcept
+				: m_pool_ptr(pool_ptr), m_node_ptr(node_ptr) {}
+
+			inline void operator()() { m_pool_ptr->run_timed_node_sub(m_node_ptr); }
+
+		private:
+
+			welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>* m_pool_ptr;
+			timed_node* m_node_ptr;
+		};
+
+		// target_ptr_Ty is the type of the box or group the continuation reports to, or std::nullptr_t
+		template <class value_Ty, class target_ptr_Ty, class function_Ty> class continuation_node : public welp::threads_continuation
+		{
+
+		public:
+
+			template <class fwd_function_Ty> continuation_node(welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>* pool_ptr,
+				target_ptr_Ty target_ptr, fwd_function_Ty&& task) : m_pool_ptr(pool_ptr), m_target_ptr(target_ptr), m_task(std::forward<fwd_function_Ty>(task))
+			{
+				this->m_launch_ptr = &launch_sub;
+			}
+
+		private:
+
+			welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>* m_pool_ptr;
+			target_ptr_Ty m_target_ptr;
+			function_Ty m_task;
+
+			// copies the value, queues the continuation and destroys the node
+			static void launch_sub(welp::threads_continuation* continuation_ptr, const void* value_ptr)
+			{
+				continuation_node* node_ptr = static_cast<continuation_node*>(continuation_ptr);
+				welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>* pool_ptr = node_ptr->m_pool_ptr;
+
+				target_ptr_Ty target_ptr = node_ptr->m_target_ptr;
+
+				// the task is moved out of the node once, if it can't be stored the target is released as denied
+				task_cell new_task;
+				bool task_made = pool_ptr->make_task_sub(new_task, target_ptr, std::move(node_ptr->m_task),
+					*static_cast<const value_Ty*>(value_ptr));
+
+				node_ptr->~continuation_node();
+				pool_ptr->deallocate(static_cast<char*>(static_cast<void*>(node_ptr)), sizeof(continuation_node));
+				if (task_made && (pool_ptr->m_task_ring.capacity() != 0))
+				{
+					pool_ptr->force_push_task_sub(new_task, pool_ptr->m_number_of_levels - 1);
+				}
+				else
+				{
+					deny_target_sub(target_ptr);
+				}
+			}
+		};
+
+		// one task and one completion counter shared by all the tasks of a batch,
+		// stored with _Allocator and destroyed by the last task if allocated is true
+		template <class function_Ty, class box_wait_Ty, bool allocated> class batch_state
+		{
+
+		public:
+
+			template <class fwd_function_Ty> batch_state(fwd_function_Ty&& task, std::size_t count,
+				welp::basic_async_task_end<box_wait_Ty>* box_ptr, _Allocator* allocator_ptr)
+				: m_task(std::forward<fwd_function_Ty>(task)), m_remaining_tasks(count), m_box_ptr(box_ptr), m_allocator_ptr(allocator_ptr) {}
+
+			inline void finish_task() noexcept
+			{
+				welp::basic_async_task_end<box_wait_Ty>* box_ptr = m_box_ptr;
+				_Allocator* allocator_ptr = m_allocator_ptr;
+				const void* address = &m_remaining_tasks;
+
+				if (m_remaining_tasks.fetch_sub(1, std::memory_order_acq_rel) != 1) { return; }
+
+				if (allocated)
+				{
+					this->~batch_state();
+					allocator_ptr->deallocate(static_cast<char*>(static_cast<void*>(this)), sizeof(batch_state));
+				}
+				if (box_ptr != nullptr)
+				{
+					const void* box_address = &box_ptr->m_task_running;
+					box_ptr->m_task_running.store(false, std::memory_order_release);
+					box_wait_Ty::notify_all(box_address);
+				}
+				else
+				{
+					wait_Ty::notify_all(address);
+				}
+			}
+
+			function_Ty m_task;
+			std::atomic<std::size_t> m_remaining_tasks;
+			welp::basic_async_task_end<box_wait_Ty>* m_box_ptr;
+			_Allocator* m_allocator_ptr;
+		};
+
+		template <class iterator_Ty, class state_Ty> class batch_task
+		{
+
+		public:
+
+			batch_task(const iterator_Ty& iterator, state_Ty* state_ptr) noexcept : m_iterator(iterator), m_state_ptr(state_ptr) {}
+
+			inline void operator()()
+			{
+				m_state_ptr->m_task(*m_iterator);
+				m_state_ptr->finish_task();
+			}
+
+		private:
+
+			iterator_Ty m_iterator;
+			state_Ty* m_state_ptr;
+		};
+
+		template <class index_Ty, class state_Ty> class range_task
+		{
+
+		public:
+
+			range_task(index_Ty begin, index_Ty end, state_Ty* state_ptr) noexcept : m_begin(begin), m_end(end), m_state_ptr(state_ptr) {}
+
+			inline void operator()()
+			{
+				for (index_Ty k = m_begin; k < m_end; k++)
+				{
+					m_state_ptr->m_task(k);
+				}
+				m_state_ptr->finish_task();
+			}
+
+		private:
+
+			index_Ty m_begin;
+			index_Ty m_end;
+			state_Ty* m_state_ptr;
+		};
+
+		// partial result of one chunk of a reduction or a scan, padded so that the chunks never share a cache line
+		template <class value_Ty> class reduce_partial
+		{
+
+		public:
+
+			std::size_t m_padding0[8];
+			alignas(value_Ty) unsigned char m_storage[sizeof(value_Ty)];
+			std::size_t m_padding1[8];
+
+			inline value_Ty& value() noexcept { return *static_cast<value_Ty*>(static_cast<void*>(m_storage)); }
+		};
+
+		class identity_transform
+		{
+
+		public:
+
+			template <class Ty> inline Ty&& operator()(Ty&& value) const noexcept { return std::forward<Ty>(value); }
+		};
+
+		// bounded multi-producer multi-consumer queue, every cell carries a sequence number
+		// telling whether it is ready to be written or ready to be read
+		class task_ring
+		{
+
+		public:
+
+			inline bool push(task_cell& new_task)
+			{
+				ring_cell* cell_ptr;
+				std::size_t position = m_push_position.load(std::memory_order_relaxed);
+				while (true)
+				{
+					cell_ptr = m_cells_ptr + (position & m_mask);
+					std::ptrdiff_t sequence_gap = static_cast<std::ptrdiff_t>(cell_ptr->m_sequence.load(std::memory_order_acquire))
+						- static_cast<std::ptrdiff_t>(position);
+					if (sequence_gap == 0)
+					{
+						if (m_push_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+						{
+							break;
+						}
+					}
+					else if (sequence_gap < 0)
+					{
+						return false;
+					}
+					else
+					{
+						position = m_push_position.load(std::memory_order_relaxed);
+					}
+				}
+				new_task.relocate_to(cell_ptr->m_task);
+				cell_ptr->m_sequence.store(position + 1, std::memory_order_release);
+				return true;
+			}
+			inline bool pop(task_cell& current_task)
+			{
+				ring_cell* cell_ptr;
+				std::size_t position = m_pop_position.load(std::memory_order_relaxed);
+				while (true)
+				{
+					cell_ptr = m_cells_ptr + (position & m_mask);
+					std::ptrdiff_t sequence_gap = static_cast<std::ptrdiff_t>(cell_ptr->m_sequence.load(std::memory_order_acquire))
+						- static_cast<std::ptrdiff_t>(position + 1);
+					if (sequence_gap == 0)
+					{
+						if (m_pop_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+						{
+							break;
+						}
+					}
+					else if (sequence_gap < 0)
+					{
+						return false;
+					}
+					else
+					{
+						position = m_pop_position.load(std::memory_order_relaxed);
+					}
+				}
+				cell_ptr->m_task.relocate_to(current_task);
+				cell_ptr->m_sequence.store(position + m_mask + 1, std::memory_order_release);
+				return true;
+			}
+			inline std::size_t capacity() const noexcept
+			{
+				return (m_cells_ptr != nullptr) ? m_mask + 1 : 0;
+			}
+			inline std::size_t size() const noexcept
+			{
+				std::size_t pop_position = m_pop_position.load(std::memory_order_relaxed);
+				std::size_t push_position = m_push_position.load(std::memory_order_relaxed);
+				return (push_position > pop_position) ? push_position - pop_position : 0;
+			}
+
+			// reserves count consecutive cells with one compare and swap, every reserved cell
+			// has to be filled with reserved_cell(position + k) and released with publish(position + k)
+			inline bool reserve(std::size_t count, std::size_t& position)
+			{
+				if (count > m_mask + 1) { return false; }
+				position = m_push_position.load(std::memory_order_relaxed);
+				while (true)
+				{
+					ring_cell* cell_ptr = m_cells_ptr + ((position + count - 1) & m_mask);
+					std::ptrdiff_t sequence_gap = static_cast<std::ptrdiff_t>(cell_ptr->m_sequence.load(std::memory_order_acquire))
+						- static_cast<std::ptrdiff_t>(position + count - 1);
+					if (sequence_gap == 0)
+					{
+						if (m_push_position.compare_exchange_weak(position, position + count, std::memory_order_relaxed))
+						{
+							return true;
+						}
+					}
+					else if (sequence_gap < 0)
+					{
+						return false;
+					}
+					else
+					{
+						position = m_push_position.load(std::memory_order_relaxed);
+					}
+				}
+			}
+			inline task_cell& reserved_cell(std::size_t position) noexcept
+			{
+				// the last cell being free, the previous ones are at most being released by consumers
+				ring_cell* cell_ptr = m_cells_ptr + (position & m_mask);
+				while (cell_ptr->m_sequence.load(std::memory_order_acquire) != position) {}
+				return cell_ptr->m_task;
+			}
+			inline void publish(std::size_t position) noexcept
+			{
+				(m_cells_ptr + (position & m_mask))->m_sequence.store(position + 1, std::memory_order_release);
+			}
+
+			class ring_cell
+			{
+
+			public:
+
+				std::atomic<std::size_t> m_sequence{ 0 };
+				task_cell m_task;
+			};
+
+			ring_cell* m_cells_ptr = nullptr;
+			std::size_t m_mask = 0;
+
+		private:
+
+			std::size_t m_padding0[8] = { 0 };
+			std::atomic<std::size_t> m_push_position{ 0 };
+			std::size_t m_padding1[8] = { 0 };
+			std::atomic<std::size_t> m_pop_position{ 0 };
+			std::size_t m_padding2[8] = { 0 };
+		};
+
+		// Chase-Lev deque, the owning thread pushes and pops at the bottom without locking and only competes
+		// with a compare and swap on top for the last task, the other threads steal at the top with a compare and swap,
+		// every cell carries the index it can next be pushed at, set once a stealing thread has moved the task out
+		class worker_deque
+		{
+
+		public:
+
+			inline bool push_bottom(task_cell& new_task)
+			{
+				std::size_t temp_bottom = m_bottom.load(std::memory_order_relaxed);
+				deque_cell* cell_ptr = m_cells_ptr + (temp_bottom & (m_capacity - 1));
+				if (cell_ptr->m_sequence.load(std::memory_order_acquire) != temp_bottom)
+				{
+					return false;
+				}
+				new_task.relocate_to(cell_ptr->m_task);
+				m_bottom.store(temp_bottom + 1, std::memory_order_release);
+				return true;
+			}
+			inline bool pop_bottom(task_cell& current_task)
+			{
+				if (empty()) { return false; }
+				std::size_t temp_bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+				m_bottom.store(temp_bottom, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				std::size_t temp_top = m_top.load(std::memory_order_relaxed);
+				std::ptrdiff_t size_left = static_cast<std::ptrdiff_t>(temp_bottom - temp_top);
+				if (size_left < 0)
+				{
+					m_bottom.store(temp_bottom + 1, std::memory_order_release);
+					return false;
+				}
+				deque_cell* cell_ptr = m_cells_ptr + (temp_bottom & (m_capacity - 1));
+				if (size_left > 0)
+				{
+					cell_ptr->m_task.relocate_to(current_task);
+					return true;
+				}
+
+				// last task, the stealing threads compete for it
+				bool task_taken = m_top.compare_exchange_strong(temp_top, temp_top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+				m_bottom.store(temp_bottom + 1, std::memory_order_release);
+				if (!task_taken)
+				{
+					return false;
+				}
+				cell_ptr->m_task.relocate_to(current_task);
+				cell_ptr->m_sequence.store(temp_bottom + m_capacity, std::memory_order_relaxed);
+				return true;
+			}
+			inline bool steal_top(task_cell& current_task)
+			{
+				if (empty()) { return false; }
+				std::size_t temp_top = m_top.load(std::memory_order_acquire);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				std::size_t temp_bottom = m_bottom.load(std::memory_order_acquire);
+				if ((static_cast<std::ptrdiff_t>(temp_bottom - temp_top) <= 0)
+					|| !m_top.compare_exchange_strong(temp_top, temp_top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				{
+					return false;
+				}
+				deque_cell* cell_ptr = m_cells_ptr + (temp_top & (m_capacity - 1));
+				cell_ptr->m_task.relocate_to(current_task);
+				cell_ptr->m_sequence.store(temp_top + m_capacity, std::memory_order_release);
+				return true;
+			}
+			inline bool empty() const noexcept
+			{
+				return static_cast<std::ptrdiff_t>(m_bottom.load(std::memory_order_relaxed) - m_top.load(std::memory_order_relaxed)) <= 0;
+			}
+
+			class deque_cell
+			{
+
+			public:
+
+				std::atomic<std::size_t> m_sequence{ 0 };
+				task_cell m_task;
+			};
+
+			// m_capacity is the capacity of the task ring, a power of two
+			deque_cell* m_cells_ptr = nullptr;
+			std::size_t m_capacity = 0;
+
+		private:
+
+			std::size_t m_padding0[8] = { 0 };
+			std::atomic<std::size_t> m_top{ 0 };
+			std::size_t m_padding1[8] = { 0 };
+			std::atomic<std::size_t> m_bottom{ 0 };
+			std::size_t m_padding2[8] = { 0 };
+		};
+
+		class worker_identity
+		{
+
+		public:
+
+			const void* pool_ptr = nullptr;
+			std::size_t thread_number = 0;
+			std::size_t node_number = 0;
+			std::size_t pop_count = 0;
+		};
+
+		// only used to park idle threads
+		std::condition_variable m_condition_var;
+		mutable std::mutex m_mutex;
+
+		class worker_slot
+		{
+
+		public:
+
+			std::thread m_thread;
+			std::atomic<bool> m_running{ false };
+		};
+
+		// counters of the thread of a slot, only written by that thread so that no counter is shared
+		class worker_stats
+		{
+
+		public:
+
+			std::size_t m_padding0[8] = { 0 };
+			std::atomic<std::uint64_t> m_tasks_run{ 0 };
+			std::atomic<std::uint64_t> m_steals{ 0 };
+			std::atomic<std::uint64_t> m_busy_ns{ 0 };
+			std::atomic<std::uint64_t> m_idle_ns{ 0 };
+			std::atomic<std::uint64_t> m_wait_histogram[WELP_THREADS_HISTOGRAM_SIZE] = {};
+			std::int64_t m_last_end_time = 0;
+			std::size_t m_padding1[8] = { 0 };
+
+			static inline void add_sub(std::atomic<std::uint64_t>& counter, std::uint64_t value) noexcept
+			{
+				counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+			}
+		};
+
+		// threads are started in free slots and leave their slot when retired, slots are only freed by delete_threads
+		worker_slot* m_worker_slots_ptr = nullptr;
+		worker_stats* m_worker_stats_ptr = nullptr;
+		std::atomic<bool> m_telemetry_on{ false };
+		std::size_t m_thread_capacity = 0;
+		std::atomic<std::size_t> m_number_of_threads{ 0 };
+		std::atomic<std::size_t> m_threads_to_retire{ 0 };
+		std::mutex m_resize_mutex;
+
+		// elastic sizing if m_max_threads is not 0, a thread is added when every thread is busy and more tasks than threads are
+		// waiting, and a thread is retired once it sleeps for m_idle_time unless m_idle_time is 0
+		std::size_t m_min_threads = 0;
+		std::size_t m_max_threads = 0;
+		std::chrono::milliseconds m_idle_time{ 0 };
+
+		// min-heap of the timed tasks, the threads of the pool queue the tasks that are due before looking for a task
+		// and sleep until the next deadline, m_timer_epoch changes every time a sleeping thread should look again
+		timed_node** m_timed_nodes_ptr = nullptr;
+		std::size_t m_timed_nodes_capacity = 0;
+		std::atomic<std::size_t> m_timed_task_count{ 0 };
+		std::atomic<std::int64_t> m_next_deadline{ INT64_MAX };
+		std::atomic<std::size_t> m_timer_epoch{ 0 };
+		std::mutex m_timer_mutex;
+
+		// level k < m_number_of_levels - 1 goes through m_level_rings_ptr[k], the lowest level through m_task_ring
+		// strict policy if m_total_weight is 0, otherwise a thread first tries the level given by its count of pops modulo the total weight
+		task_ring* m_level_rings_ptr = nullptr;
+		task_ring m_task_ring;
+		std::size_t m_number_of_levels = 2;
+		std::size_t m_level_weights[WELP_THREADS_MAX_PRIORITY_LEVELS] = { 0 };
+		std::size_t m_total_weight = 0;
+
+		std::atomic<std::size_t> m_waiting_tasks{ 0 };
+		std::atomic<std::size_t> m_unfinished_tasks{ 0 };
+		std::atomic<std::size_t> m_sleeping_threads{ 0 };
+
+		// threads waiting for a free spot with try_async_task_for, the condition is only notified if m_space_waiters is not 0
+		std::mutex m_space_mutex;
+		std::condition_variable m_space_condition_var;
+		std::atomic<std::size_t> m_space_waiters{ 0 };
+
+		// tasks spilled while the queue is full, counted in m_waiting_tasks, every task run moves one back to its queue
+		class spill_node
+		{
+
+		public:
+
+			task_cell m_task;
+			std::size_t m_level = 0;
+			spill_node* m_next_ptr = nullptr;
+		};
+
+		welp::threads_overflow m_overflow_policy = welp::threads_overflow::reject;
+		spill_node* m_spill_head_ptr = nullptr;
+		spill_node* m_spill_tail_ptr = nullptr;
+		std::atomic<std::size_t> m_spilled_tasks{ 0 };
+		std::mutex m_spill_mutex;
+
+		// work stealing mode only
+		worker_deque* m_worker_deques_ptr = nullptr;
+
+		// threads created with an affinity only, tasks queued from a node go to the queue of the node if node queues are enabled
+		welp::threads_affinity* m_affinity_ptr = nullptr;
+		task_ring* m_node_rings_ptr = nullptr;
+		std::size_t m_number_of_nodes = 0;
+
+		std::atomic<bool> m_waiting_for_finish{ false };
+		bool m_stop_threads = true;
+
+		threads(const welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>&) = delete;
+		welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>& operator=(const welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>&) = delete;
+		threads(welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>&&) = delete;
+		welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>& operator=(welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>&&) = delete;
+
+
+		template <class function_Ty, class ... _Args>
+		void bind_task_sub(task_cell& new_task, std::nullptr_t, function_Ty&& task, _Args&& ... args);
+		template <class box_wait_Ty, class function_Ty, class ... _Args>
+		void bind_task_sub(task_cell& new_task, welp::basic_async_task_end<box_wait_Ty>* box_ptr, function_Ty&& task, _Args&& ... args);
+		template <class return_Ty, class box_wait_Ty, class function_Ty, class ... _Args>
+		void bind_task_sub(task_cell& new_task, welp::async_task_result<return_Ty, box_wait_Ty>* box_ptr, function_Ty&& task, _Args&& ... args);
+		template <class group_wait_Ty, class function_Ty, class ... _Args>
+		void bind_task_sub(task_cell& new_task, welp::basic_task_group<group_wait_Ty>* group_ptr, function_Ty&& task, _Args&& ... args);
+		template <class target_ptr_Ty, class function_Ty, class ... _Args>
+		bool make_task_sub(task_cell& new_task, target_ptr_Ty target_ptr, function_Ty&& task, _Args&& ... args) noexcept;
+		template <class target_ptr_Ty, class function_Ty, class ... _Args>
+		void force_make_task_sub(task_cell& new_task, target_ptr_Ty target_ptr, function_Ty&& task, _Args&& ... args);
+		static inline void deny_target_sub(std::nullptr_t) noexcept {}
+		template <class box_wait_Ty> static void deny_target_sub(welp::basic_async_task_end<box_wait_Ty>* box_ptr);
+		template <class return_Ty, class box_wait_Ty> static void deny_target_sub(welp::async_task_result<return_Ty, box_wait_Ty>* box_ptr);
+		template <class group_wait_Ty> static void deny_target_sub(welp::basic_task_group<group_wait_Ty>* group_ptr) noexcept;
+		inline bool push_task_sub(task_cell& new_task, std::size_t level);
+		bool push_task_sub(task_cell& new_task, std::size_t level, welp::threads_overflow overflow_policy);
+		void force_push_task_sub(task_cell& new_task, std::size_t level);
+		bool push_task_until_sub(task_cell& new_task, std::size_t level, std::chrono::steady_clock::time_point deadline);
+		bool spill_task_sub(task_cell& new_task, std::size_t level) noexcept;
+		bool pop_spilled_task_sub(task_cell& current_task) noexcept;
+		void refill_sub() noexcept;
+		void delete_spilled_tasks_sub() noexcept;
+		inline std::size_t level_sub(welp::threads_priority priority) const noexcept;
+		inline std::size_t reduce_chunks_sub(std::size_t count) const noexcept;
+		static inline std::size_t chunk_begin_sub(std::size_t count, std::size_t number_of_chunks, std::size_t chunk) noexcept;
+		template <class make_Ty> bool push_block_sub(std::size_t count, make_Ty&& make_task);
+		void wait_batch_sub(const std::atomic<std::size_t>& remaining_tasks) noexcept;
+		template <class value_Ty, class value_wait_Ty, class target_ptr_Ty, class function_Ty>
+		bool then_sub(welp::async_task_result<value_Ty, value_wait_Ty>& box, target_ptr_Ty target_ptr, function_Ty&& task);
+		template <class box_wait_Ty, class iterator_Ty, class function_Ty>
+		bool async_batch_sub(welp::basic_async_task_end<box_wait_Ty>* box_ptr, iterator_Ty first, iterator_Ty last, function_Ty&& task);
+		inline void run_task_sub(task_cell& current_task);
+		inline void wake_threads_sub(std::size_t count);
+		inline bool pop_task_sub(task_cell& current_task, std::size_t thread_number);
+		inline bool pop_level_sub(task_cell& current_task, std::size_t thread_number, std::size_t level);
+		void worker_loop_sub(std::size_t thread_number);
+
+		bool new_threads_sub(std::size_t input_number_of_threads, std::size_t input_task_buffer_size, const welp::threads_affinity* affinity_ptr);
+		bool new_ring_sub(task_ring& ring, std::size_t ring_capacity);
+		void delete_ring_sub(task_ring& ring) noexcept;
+		void pin_thread_sub(std::size_t thread_number) noexcept;
+		std::size_t add_threads_sub(std::size_t number_of_new_threads, std::size_t max_number_of_threads);
+		bool retire_thread_sub(std::size_t thread_number, bool idle) noexcept;
+		inline void grow_sub();
+		bool new_deque_sub(std::size_t thread_number);
+		inline void run_worker_task_sub(task_cell& current_task, std::size_t thread_number);
+		inline void count_steal_sub() noexcept;
+		static inline std::int64_t telemetry_time_sub() noexcept;
+		void add_stats_sub(welp::threads_snapshot& stats, std::size_t thread_number) const noexcept;
+
+		bool schedule_sub(timed_node* node_ptr);
+		bool insert_timed_node_sub(timed_node* node_ptr, bool& earliest_deadline);
+		void dispatch_timed_tasks_sub();
+		void run_timed_node_sub(timed_node* node_ptr);
+		void delete_timed_node_sub(timed_node* node_ptr) noexcept;
+		inline void update_next_deadline_sub() noexcept;
+		static inline bool later_deadline_sub(const timed_node* lhs_ptr, const timed_node* rhs_ptr) noexcept;
+		template <class box_wait_Ty> static void cancel_recurring_sub(void* pool_ptr, welp::basic_recurring_task<box_wait_Ty>* box_ptr);
+		template <class box_wait_Ty> static void finish_recurring_sub(void* box_ptr) noexcept;
+		inline std::size_t local_node_sub() const noexcept;
+
+		inline bool is_local_worker_sub() const noexcept;
+		inline worker_deque* local_deque_sub() const noexcept;
+		static inline worker_identity& local_identity_sub() noexcept;
+
+#ifdef WELP_THREADS_DEBUG_MODE
+		std::atomic<WELP_THREADS_RECORD_INT> m_DEBUG_record_max_occupancy{ 0 };
+		std::atomic<WELP_THREADS_RECORD_INT> m_DEBUG_record_completed_task_count{ 0 };
+		std::atomic<WELP_THREADS_RECORD_INT> m_DEBUG_record_accepted_task_count{ 0 };
+		std::atomic<WELP_THREADS_RECORD_INT> m_DEBUG_record_denied_task_count{ 0 };
+		std::atomic<WELP_THREADS_RECORD_INT> m_DEBUG_record_delayed_task_count{ 0 };
+		bool m_DEBUG_record_on = false;
+
+		void DEBUG_say_sub();
+		void DEBUG_write_sub(std::ofstream& rec_write);
+#endif // WELP_THREADS_DEBUG_MODE
+	};
+
+	// directed acyclic graph of tasks to run on a welp::threads, every task of the graph is queued
+	// by the thread finishing its last predecessor, the graph can be run again once it is done
+	template <class threads_Ty> class task_graph : private threads_Ty::allocator_type
+	{
+
+	public:
+
+		template <class function_Ty, class ... _Args> bool add_task(std::size_t& task_index, function_Ty&& task, _Args&& ... args);
+		bool add_dependency(std::size_t first_task_index, std::size_t next_task_index) noexcept;
+
+		bool run(threads_Ty& pool);
+		inline void wait() const noexcept;
+		inline bool is_done() const noexcept;
+
+		inline std::size_t number_of_tasks() const noexcept;
+		inline std::size_t number_of_dependencies() const noexcept;
+		inline bool owns_resources() const noexcept;
+
+		bool new_graph(std::size_t max_number_of_tasks, std::size_t max_number_of_dependencies);
+		void delete_graph() noexcept;
+
+		task_graph() = default;
+		~task_graph() { delete_graph(); }
+
+	private:
+
+		using task_cell = typename threads_Ty::task_cell;
+
+		class graph_node
+		{
+
+		public:
+
+			task_cell m_task;
+			std::atomic<std::size_t> m_pending_predecessors{ 0 };
+			std::size_t m_number_of_predecessors = 0;
+			std::size_t m_first_successor = 0;
+			std::size_t m_number_of_successors = 0;
+		};
+
+		class graph_dependency
+		{
+
+		public:
+
+			std::size_t first_task_index;
+			std::size_t next_task_index;
+		};
+
+		class node_task
+		{
+
+		public:
+
+			node_task(welp::task_graph<threads_Ty>* graph_ptr, std::size_t task_index) noexcept : m_graph_ptr(graph_ptr), m_task_index(task_index) {}
+
+			inline void operator()() { m_graph_ptr->run_task_sub(m_task_index); }
+
+		private:
+
+			welp::task_graph<threads_Ty>* m_graph_ptr;
+			std::size_t m_task_index;
+		};
+
+		graph_node* m_nodes_ptr = nullptr;
+		std::size_t m_number_of_tasks = 0;
+		std::size_t m_max_number_of_tasks = 0;
+
+		graph_dependency* m_dependencies_ptr = nullptr;
+		std::size_t* m_successors_ptr = nullptr;
+		std::size_t* m_ready_tasks_ptr = nullptr;
+		std::size_t m_number_of_dependencies = 0;
+		std::size_t m_max_number_of_dependencies = 0;
+
+		threads_Ty* m_pool_ptr = nullptr;
+		std::atomic<std::size_t> m_remaining_tasks{ 0 };
+		bool m_graph_sorted = false;
+
+		bool sort_graph_sub() noexcept;
+		void queue_task_sub(std::size_t task_index);
+		void run_task_sub(std::size_t task_index);
+
+		task_graph(const welp::task_graph<threads_Ty>&) = delete;
+		welp::task_graph<threads_Ty>& operator=(const welp::task_graph<threads_Ty>&) = delete;
+		task_graph(welp::task_graph<threads_Ty>&&) = delete;
+		welp::task_graph<threads_Ty>& operator=(welp::task_graph<threads_Ty>&&) = delete;
+	};
+}
+
+
+////// IMPLEMENTATIONS //////
+
+template <class predicate_Ty> inline void welp::threads_adaptive_wait::wait_until(const void* address, predicate_Ty&& ready) noexcept
+{
+	for (std::size_t k = 0; k < spin_count; k++)
+	{
+		if (ready()) { return; }
+		pause_sub();
+	}
+	for (std::size_t k = 0; k < yield_count; k++)
+	{
+		if (ready()) { return; }
+		std::this_thread::yield();
+	}
+
+	parking_slot& slot = parking_slot_sub(address);
+	std::unique_lock<std::mutex> lock(slot.m_mutex);
+	slot.m_parked_threads.fetch_add(1);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	while (!ready())
+	{
+		slot.m_condition_var.wait(lock);
+	}
+	slot.m_parked_threads.fetch_sub(1);
+}
+
+inline void welp::threads_adaptive_wait::notify_all(const void* address) noexcept
+{
+	parking_slot& slot = parking_slot_sub(address);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (slot.m_parked_threads.load(std::memory_order_relaxed) != 0)
+	{
+		{
+			std::lock_guard<std::mutex> lock(slot.m_mutex);
+		}
+		slot.m_condition_var.notify_all();
+	}
+}
+
+inline welp::threads_affinity welp::threads_affinity::all_cpus() noexcept
+{
+	welp::threads_affinity affinity;
+	affinity.detect_topology_sub();
+	for (std::size_t node = 0; node < affinity.m_number_of_nodes; node++)
+	{
+		for (int cpu = 0; cpu < WELP_THREADS_MAX_CPUS; cpu++)
+		{
+			if (affinity.m_cpu_nodes[cpu] == static_cast<int>(node))
+			{
+				affinity.m_slot_cpus[affinity.m_number_of_slots] = cpu;
+				affinity.m_slot_nodes[affinity.m_number_of_slots] = node;
+				affinity.m_number_of_slots++;
+			}
+		}
+	}
+	return affinity;
+}
+
+inline welp::threads_affinity welp::threads_affinity::physical_cores() noexcept
+{
+	welp::threads_affinity affinity = welp::threads_affinity::all_cpus();
+#ifdef WELP_THREADS_LINUX_AFFINITY
+	bool siblings[WELP_THREADS_MAX_CPUS];
+	char path[96];
+	std::size_t number_of_cores = 0;
+	for (std::size_t slot = 0; slot < affinity.m_number_of_slots; slot++)
+	{
+		// a core is represented by the lowest of its hardware threads available to the process
+		int cpu = affinity.m_slot_cpus[slot];
+		std::snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/thread_siblings_list", cpu);
+		bool representative = true;
+		if (welp::threads_affinity::read_cpu_list_sub(path, siblings))
+		{
+			for (int sibling = 0; sibling < cpu; sibling++)
+			{
+				if (siblings[sibling] && (affinity.m_cpu_nodes[sibling] >= 0))
+				{
+					representative = false;
+					break;
+				}
+			}
+		}
+		if (representative)
+		{
+			affinity.m_slot_cpus[number_of_cores] = cpu;
+			affinity.m_slot_nodes[number_of_cores] = affinity.m_slot_nodes[slot];
+			number_of_cores++;
+		}
+	}
+	affinity.m_number_of_slots = number_of_cores;
+#endif // WELP_THREADS_LINUX_AFFINITY
+	return affinity;
+}
+
+inline welp::threads_affinity welp::threads_affinity::numa_nodes() noexcept
+{
+	welp::threads_affinity affinity;
+	affinity.detect_topology_sub();
+	for (std::size_t node = 0; node < affinity.m_number_of_nodes; node++)
+	{
+		affinity.m_slot_cpus[node] = -1;
+		affinity.m_slot_nodes[node] = node;
+	}
+	affinity.m_number_of_slots = affinity.m_number_of_nodes;
+	return affinity;
+}
+
+inline bool welp::threads_affinity::add_cpu(int cpu) noexcept
+{
+	detect_topology_sub();
+	if ((cpu < 0) || (cpu >= WELP_THREADS_MAX_CPUS) || (m_cpu_nodes[cpu] < 0) || (m_number_of_slots == WELP_THREADS_MAX_CPUS))
+	{
+		return false;
+	}
+	m_slot_cpus[m_number_of_slots] = cpu;
+	m_slot_nodes[m_number_of_slots] = static_cast<std::size_t>(m_cpu_nodes[cpu]);
+	m_number_of_slots++;
+	return true;
+}
+
+inline welp::threads_affinity& welp::threads_affinity::node_queues(bool enable) noexcept
+{
+	m_node_queues = enable;
+	return *this;
+}
+
+inline void welp::threads_affinity::detect_topology_sub() noexcept
+{
+	if (m_topology_detected)
+	{
+		return;
+	}
+	m_topology_detected = true;
+	m_number_of_nodes = 1;
+
+#ifdef WELP_THREADS_LINUX_AFFINITY
+	cpu_set_t process_cpus;
+	CPU_ZERO(&process_cpus);
+	bool restricted = (sched_getaffinity(0, sizeof(cpu_set_t), &process_cpus) == 0);
+	std::size_t number_of_cpus = 0;
+	for (int cpu = 0; cpu < WELP_THREADS_MAX_CPUS; cpu++)
+	{
+		bool available = (cpu < CPU_SETSIZE) && (restricted ? CPU_ISSET(cpu, &process_cpus) : (cpu < static_cast<int>(std::thread::hardware_concurrency())));
+		m_cpu_nodes[cpu] = available ? 0 : -1;
+		number_of_cpus += available ? 1 : 0;
+	}
+
+	// nodes without any CPU available to the process are skipped
+	bool node_cpus[WELP_THREADS_MAX_CPUS];
+	char path[64];
+	std::size_t number_of_nodes = 0;
+	for (int node = 0; node < WELP_THREADS_MAX_CPUS; node++)
+	{
+		std::snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+		if (!welp::threads_affinity::read_cpu_list_sub(path, node_cpus))
+		{
+			continue;
+		}
+		bool node_used = false;
+		for (int cpu = 0; cpu < WELP_THREADS_MAX_CPUS; cpu++)
+		{
+			if (node_cpus[cpu] && (m_cpu_nodes[cpu] >= 0))
+			{
+				m_cpu_nodes[cpu] = static_cast<int>(number_of_nodes);
+				node_used = true;
+			}
+		}
+		number_of_nodes += node_used ? 1 : 0;
+	}
+	m_number_of_nodes = (number_of_nodes != 0) ? number_of_nodes : 1;
+	if (number_of_cpus == 0)
+	{
+		m_cpu_nodes[0] = 0;
+	}
+#else
+	std::size_t number_of_cpus = static_cast<std::size_t>(std::thread::hardware_concurrency());
+	number_of_cpus = (number_of_cpus == 0) ? 1 : number_of_cpus;
+	for (int cpu = 0; cpu < WELP_THREADS_MAX_CPUS; cpu++)
+	{
+		m_cpu_nodes[cpu] = (static_cast<std::size_t>(cpu) < number_of_cpus) ? 0 : -1;
+	}
+#endif // WELP_THREADS_LINUX_AFFINITY
+}
+
+// reads lists of the form 0-3,8,10-11 as written by the kernel in /sys
+inline bool welp::threads_affinity::read_cpu_list_sub(const char* path, bool* cpus_ptr) noexcept
+{
+	for (int cpu = 0; cpu < WELP_THREADS_MAX_CPUS; cpu++)
+	{
+		*(cpus_ptr + cpu) = false;
+	}
+#ifdef WELP_THREADS_LINUX_AFFINITY
+	std::FILE* file_ptr = std::fopen(path, "r");
+	if (file_ptr == nullptr)
+	{
+		return false;
+	}
+	int first_cpu;
+	while (std::fscanf(file_ptr, "%d", &first_cpu) == 1)
+	{
+		int last_cpu = first_cpu;
+		int separator = std::fgetc(file_ptr);
+		if (separator == '-')
+		{
+			if (std::fscanf(file_ptr, "%d", &last_cpu) != 1)
+			{
+				break;
+			}
+			separator = std::fgetc(file_ptr);
+		}
+		for (int cpu = (first_cpu > 0) ? first_cpu : 0; (cpu <= last_cpu) && (cpu < WELP_THREADS_MAX_CPUS); cpu++)
+		{
+			*(cpus_ptr + cpu) = true;
+		}
+		if (separator != ',')
+		{
+			break;
+		}
+	}
+	std::fclose(file_ptr);
+	return true;
+#else
+	(void)path;
+	return false;
+#endif // WELP_THREADS_LINUX_AFFINITY
+}
+
+
+template <class wait_Ty> inline void welp::basic_async_task_end<wait_Ty>::finish_task() const noexcept
+{
+	wait_Ty::wait_until(&m_task_running, [this]() { return !m_task_running.load(std::memory_order_acquire); });
+}
+
+template <class wait_Ty> inline bool welp::basic_async_task_end<wait_Ty>::task_running() const noexcept
+{
+	return m_task_running.load(std::memory_order_acquire);
+}
+template <class wait_Ty> inline bool welp::basic_async_task_end<wait_Ty>::task_denied() const noexcept
+{
+	return m_task_denied.load(std::memory_order_acquire);
+}
+template <class wait_Ty> inline bool welp::basic_async_task_end<wait_Ty>::task_cancelled() const noexcept
+{
+	return m_task_cancelled.load(std::memory_order_acquire);
+}
+
+template <class wait_Ty> void welp::basic_async_task_end<wait_Ty>::reset()
+{
+	finish_task();
+	m_task_running.store(false, std::memory_order_release);
+	m_task_denied.store(false, std::memory_order_release);
+	m_task_cancelled.store(false, std::memory_order_release);
+}
+
+template <class wait_Ty> welp::basic_async_task_end<wait_Ty>::~basic_async_task_end()
+{
+	finish_task();
+}
+
+
+template <class Ty, class wait_Ty> inline const Ty& welp::async_task_result<Ty, wait_Ty>::get() const noexcept
+{
+	wait_Ty::wait_until(&m_task_running, [this]() { return !m_task_running.load(std::memory_order_acquire); });
+	return m_stored_value;
+}
+template <class Ty, class wait_Ty> inline Ty& welp::async_task_result<Ty, wait_Ty>::get() noexcept
+{
+	wait_Ty::wait_until(&m_task_running, [this]() { return !m_task_running.load(std::memory_order_acquire); });
+	return m_stored_value;
+}
+
+template <class Ty, class wait_Ty> inline bool welp::async_task_result<Ty, wait_Ty>::task_running() const noexcept
+{
+	return m_task_running.load(std::memory_order_acquire);
+}
+template <class Ty, class wait_Ty> inline bool welp::async_task_result<Ty, wait_Ty>::task_denied() const noexcept
+{
+	return m_task_denied.load(std::memory_order_acquire);
+}
+template <class Ty, class wait_Ty> inline bool welp::async_task_result<Ty, wait_Ty>::task_cancelled() const noexcept
+{
+	return m_task_cancelled.load(std::memory_order_acquire);
+}
+
+template <class Ty, class wait_Ty> void welp::async_task_result<Ty, wait_Ty>::reset()
+{
+	wait_Ty::wait_until(&m_task_running, [this]() { return !m_task_running.load(std::memory_order_acquire); });
+	m_stored_value = Ty();
+	m_task_running.store(false, std::memory_order_release);
+	m_task_denied.store(false, std::memory_order_release);
+	m_task_cancelled.store(false, std::memory_order_release);
+	m_continuation_ptr.store(welp::threads_continuation::unbound(), std::memory_order_release);
+}
+
+template <class Ty, class wait_Ty> welp::async_task_result<Ty, wait_Ty>::~async_task_result()
+{
+	wait_Ty::wait_until(&m_task_running, [this]() { return !m_task_running.load(std::memory_order_acquire); });
+}
+
+#ifdef WELP_THREADS_COROUTINES
+// returns false and lets the coroutine go on if the task finished in the meantime
+template <class Ty, class wait_Ty> inline bool welp::async_task_result<Ty, wait_Ty>::awaiter::await_suspend(std::coroutine_handle<> handle) noexcept
+{
+	m_handle = handle;
+	welp::threads_continuation* head_ptr = m_box_ptr->m_continuation_ptr.load(std::memory_order_acquire);
+	while (true)
+	{
+		if ((head_ptr == welp::threads_continuation::finished()) || (head_ptr == welp::threads_continuation::unbound()))
+		{
+			return false;
+		}
+		m_next_ptr = head_ptr;
+		if (m_box_ptr->m_continuation_ptr.compare_exchange_weak(head_ptr, this, std::memory_order_acq_rel, std::memory_order_acquire))
+		{
+			return true;
+		}
+	}
+}
+#endif // WELP_THREADS_COROUTINES
+
+
+template <class wait_Ty> inline void welp::basic_task_group<wait_Ty>::wait() const noexcept
+{
+	wait_Ty::wait_until(&m_count, [this]() { return m_count.load(std::memory_order_acquire) == 0; });
+}
+
+// spins and yields like wait() but never parks the thread, returns true if every task is finished
+template <class wait_Ty> inline bool welp::basic_task_group<wait_Ty>::try_wait() const noexcept
+{
+	for (std::size_t k = 0; k < 64; k++)
+	{
+		if (m_count.load(std::memory_order_acquire) == 0) { return true; }
+		std::this_thread::yield();
+	}
+	return m_count.load(std::memory_order_acquire) == 0;
+}
+
+template <class wait_Ty> inline bool welp::basic_task_group<wait_Ty>::is_done() const noexcept
+{
+	return m_count.load(std::memory_order_acquire) == 0;
+}
+
+template <class wait_Ty> inline std::size_t welp::basic_task_group<wait_Ty>::count() const noexcept
+{
+	return m_count.load(std::memory_order_acquire);
+}
+
+template <class wait_Ty> inline void welp::basic_task_group<wait_Ty>::add_count(std::size_t number_of_tasks) noexcept
+{
+	m_count.fetch_add(number_of_tasks, std::memory_order_relaxed);
+}
+
+// the group can be destroyed as soon as the count reaches 0, the notification only uses its address
+template <class wait_Ty> inline void welp::basic_task_group<wait_Ty>::count_down() noexcept
+{
+	const void* address = &m_count;
+	if (m_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		wait_Ty::notify_all(address);
+	}
+}
+
+template <class wait_Ty> welp::basic_task_group<wait_Ty>::~basic_task_group()
+{
+	wait();
+}
+
+
+template <class wait_Ty> inline void welp::basic_recurring_task<wait_Ty>::cancel() noexcept
+{
+	if (m_scheduled.load(std::memory_order_acquire))
+	{
+		m_cancel_ptr(m_pool_ptr, this);
+		wait_Ty::wait_until(&m_scheduled, [this]() { return !m_scheduled.load(std::memory_order_acquire); });
+	}
+}
+
+template <class wait_Ty> inline bool welp::basic_recurring_task<wait_Ty>::task_scheduled() const noexcept
+{
+	return m_scheduled.load(std::memory_order_acquire);
+}
+
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class callable_Ty>
+inline void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::task_cell::store(callable_Ty&& callable, _Allocator& allocator)
+{
+	using stored_Ty = typename std::decay<callable_Ty>::type;
+	static_assert(alignof(stored_Ty) <= alignof(std::max_align_t), "welp::threads : over-aligned tasks are not supported");
+
+	constexpr bool stored_in_place = (sizeof(stored_Ty) <= task_cell_size)
+		&& std::is_nothrow_move_constructible<stored_Ty>::value;
+
+#ifdef WELP_THREADS_FORBID_TASK_ALLOCATION
+	static_assert(stored_in_place, "welp::threads : task and arguments do not fit in task_cell_size bytes");
+#endif // WELP_THREADS_FORBID_TASK_ALLOCATION
+
+	clear();
+	store_sub(std::forward<callable_Ty>(callable), allocator, std::integral_constant<bool, stored_in_place>());
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class callable_Ty>
+inline void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::task_cell::store_sub(callable_Ty&& callable, _Allocator&, std::true_type)
+{
+	using stored_Ty = typename std::decay<callable_Ty>::type;
+	new (static_cast<void*>(m_storage)) stored_Ty(std::forward<callable_Ty>(callable));
+	m_invoke_ptr = &invoke_inline_sub<stored_Ty>;
+	m_manage_ptr = &manage_inline_sub<stored_Ty>;
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class callable_Ty>
+inline void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::task_cell::store_sub(callable_Ty&& callable, _Allocator& allocator, std::false_type)
+{
+	using stored_Ty = typename std::decay<callable_Ty>::type;
+	char* task_ptr = allocator.allocate(sizeof(stored_Ty));
+	if (task_ptr == nullptr) { throw std::bad_alloc(); }
+	try
+	{
+		new (static_cast<void*>(task_ptr)) stored_Ty(std::forward<callable_Ty>(callable));
+	}
+	catch (...)
+	{
+		allocator.deallocate(task_ptr, sizeof(stored_Ty));
+		throw;
+	}
+	heap_task* heap_ptr = new (static_cast<void*>(m_storage)) heap_task();
+	heap_ptr->task_ptr = static_cast<void*>(task_ptr);
+	heap_ptr->allocator_ptr = &allocator;
+	m_invoke_ptr = &invoke_heap_sub<stored_Ty>;
+	m_manage_ptr = &manage_heap_sub<stored_Ty>;
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+inline void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::task_cell::run()
+{
+	m_invoke_ptr(m_storage);
+	clear();
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+inline void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::task_cell::invoke()
+{
+	m_invoke_ptr(m_storage);
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+inline void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::task_cell::relocate_to(task_cell& destination) noexcept
+{
+	m_manage_ptr(m_storage, destination.m_storage);
+	destination.m_invoke_ptr = m_invoke_ptr;
+	destination.m_manage_ptr = m_manage_ptr;
+#ifndef WELP_THREADS_NO_TELEMETRY
+	destination.m_queued_time = m_queued_time;
+#endif // WELP_THREADS_NO_TELEMETRY
+	m_invoke_ptr = nullptr;
+	m_manage_ptr = nullptr;
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+inline void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::task_cell::clear() noexcept
+{
+	if (m_manage_ptr != nullptr)
+	{
+		m_manage_ptr(m_storage, nullptr);
+		m_invoke_ptr = nullptr;
+		m_manage_ptr = nullptr;
+	}
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class callable_Ty>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::task_cell::invoke_inline_sub(unsigned char* storage_ptr)
+{
+	(*static_cast<callable_Ty*>(static_cast<void*>(storage_ptr)))();
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class callable_Ty>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::task_cell::manage_inline_sub(unsigned char* storage_ptr, unsigned char* destination_ptr) noexcept
+{
+	callable_Ty* task_ptr = static_cast<callable_Ty*>(static_cast<void*>(storage_ptr));
+	if (destination_ptr != nullptr)
+	{
+		new (static_cast<void*>(destination_ptr)) callable_Ty(std::move(*task_ptr));
+	}
+	task_ptr->~callable_Ty();
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class callable_Ty>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::task_cell::invoke_heap_sub(unsigned char* storage_ptr)
+{
+	(*static_cast<callable_Ty*>(static_cast<heap_task*>(static_cast<void*>(storage_ptr))->task_ptr))();
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class callable_Ty>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::task_cell::manage_heap_sub(unsigned char* storage_ptr, unsigned char* destination_ptr) noexcept
+{
+	heap_task* heap_ptr = static_cast<heap_task*>(static_cast<void*>(storage_ptr));
+	if (destination_ptr != nullptr)
+	{
+		*static_cast<heap_task*>(static_cast<void*>(destination_ptr)) = *heap_ptr;
+	}
+	else
+	{
+		static_cast<callable_Ty*>(heap_ptr->task_ptr)->~callable_Ty();
+		heap_ptr->allocator_ptr->deallocate(static_cast<char*>(heap_ptr->task_ptr), sizeof(callable_Ty));
+	}
+}
+
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class function_Ty, class ... _Args>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::async_task(function_Ty&& task, _Args&& ... args)
+{
+	task_cell new_task;
+	if (make_task_sub(new_task, nullptr, std::forward<function_Ty>(task), std::forward<_Args>(args)...) && push_task_sub(new_task, m_number_of_levels - 1))
+	{
+		return true;
+	}
+	else
+	{
+#ifdef WELP_THREADS_DEBUG_MODE
+		if (m_DEBUG_record_on)
+		{
+			m_DEBUG_record_denied_task_count.fetch_add(1);
+		}
+#endif // WELP_THREADS_DEBUG_MODE
+
+		return false;
+	}
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class function_Ty, class ... _Args>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::force_async_task(function_Ty&& task, _Args&& ... args)
+{
+	task_cell new_task;
+	force_make_task_sub(new_task, nullptr, std::forward<function_Ty>(task), std::forward<_Args>(args)...);
+
+#ifdef WELP_THREADS_DEBUG_MODE
+	if (!push_task_sub(new_task, m_number_of_levels - 1))
+	{
+		m_DEBUG_record_delayed_task_count.fetch_add(1);
+	}
+	else { return; }
+#endif // WELP_THREADS_DEBUG_MODE
+	force_push_task_sub(new_task, m_number_of_levels - 1);
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class function_Ty, class ... _Args>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::priority_async_task(function_Ty&& task, _Args&& ... args)
+{
+	task_cell new_task;
+	if (make_task_sub(new_task, nullptr, std::forward<function_Ty>(task), std::forward<_Args>(args)...) && push_task_sub(new_task, 0))
+	{
+		return true;
+	}
+	else
+	{
+#ifdef WELP_THREADS_DEBUG_MODE
+		if (m_DEBUG_record_on)
+		{
+			m_DEBUG_record_denied_task_count.fetch_add(1);
+		}
+#endif // WELP_THREADS_DEBUG_MODE
+
+		return false;
+	}
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class function_Ty, class ... _Args>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::force_priority_async_task(function_Ty&& task, _Args&& ... args)
+{
+	task_cell new_task;
+	force_make_task_sub(new_task, nullptr, std::forward<function_Ty>(task), std::forward<_Args>(args)...);
+
+#ifdef WELP_THREADS_DEBUG_MODE
+	if (!push_task_sub(new_task, 0))
+	{
+		m_DEBUG_record_delayed_task_count.fetch_add(1);
+	}
+	else { return; }
+#endif // WELP_THREADS_DEBUG_MODE
+	force_push_task_sub(new_task, 0);
+}
+
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class box_wait_Ty, class function_Ty, class ... _Args>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::async_task(welp::basic_async_task_end<box_wait_Ty>& box, function_Ty&& task, _Args&& ... args)
+{
+	if (!box.m_task_running.load(std::memory_order_acquire))
+	{
+		box.m_task_running.store(true, std::memory_order_release);
+		box.m_task_denied.store(false, std::memory_order_release);
+		box.m_task_cancelled.store(false, std::memory_order_release);
+
+		task_cell new_task;
+		if (make_task_sub(new_task, &box, std::forward<function_Ty>(task), std::forward<_Args>(args)...) && push_task_sub(new_task, m_number_of_levels - 1))
+		{
+			return true;
+		}
+
+		box.m_task_running.store(false, std::memory_order_release);
+	}
+
+	box.m_task_denied.store(true, std::memory_order_release);
+
+#ifdef WELP_THREADS_DEBUG_MODE
+	if (m_DEBUG_record_on)
+	{
+		m_DEBUG_record_denied_task_count.fetch_add(1);
+	}
+#endif // WELP_THREADS_DEBUG_MODE
+
+	return false;
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class box_wait_Ty, class function_Ty, class ... _Args>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::force_async_task(welp::basic_async_task_end<box_wait_Ty>& box, function_Ty&& task, _Args&& ... args)
+{
+	box_wait_Ty::wait_until(&box.m_task_running, [&box]() { return !box.m_task_running.load(std::memory_order_acquire); });
+	box.m_task_running.store(true, std::memory_order_release);
+	box.m_task_denied.store(false, std::memory_order_release);
+	box.m_task_cancelled.store(false, std::memory_order_release);
+
+	task_cell new_task;
+	force_make_task_sub(new_task, &box, std::forward<function_Ty>(task), std::forward<_Args>(args)...);
+
+#ifdef WELP_THREADS_DEBUG_MODE
+	if (!push_task_sub(new_task, m_number_of_levels - 1))
+	{
+		m_DEBUG_record_delayed_task_count.fetch_add(1, std::memory_order_relaxed);
+	}
+	else { return; }
+#endif // WELP_THREADS_DEBUG_MODE
+	force_push_task_sub(new_task, m_number_of_levels - 1);
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class box_wait_Ty, class function_Ty, class ... _Args>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::priority_async_task(welp::basic_async_task_end<box_wait_Ty>& box, function_Ty&& task, _Args&& ... args)
+{
+	if (!box.m_task_running.load(std::memory_order_acquire))
+	{
+		box.m_task_running.store(true, std::memory_order_release);
+		box.m_task_denied.store(false, std::memory_order_release);
+		box.m_task_cancelled.store(false, std::memory_order_release);
+
+		task_cell new_task;
+		if (make_task_sub(new_task, &box, std::forward<function_Ty>(task), std::forward<_Args>(args)...) && push_task_sub(new_task, 0))
+		{
+			return true;
+		}
+
+		box.m_task_running.store(false, std::memory_order_release);
+	}
+
+	box.m_task_denied.store(true, std::memory_order_release);
+
+#ifdef WELP_THREADS_DEBUG_MODE
+	if (m_DEBUG_record_on)
+	{
+		m_DEBUG_record_denied_task_count.fetch_add(1);
+	}
+#endif // WELP_THREADS_DEBUG_MODE
+
+	return false;
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class box_wait_Ty, class function_Ty, class ... _Args>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::force_priority_async_task(welp::basic_async_task_end<box_wait_Ty>& box, function_Ty&& task, _Args&& ... args)
+{
+	box_wait_Ty::wait_until(&box.m_task_running, [&box]() { return !box.m_task_running.load(std::memory_order_acquire); });
+	box.m_task_running.store(true, std::memory_order_release);
+	box.m_task_denied.store(false, std::memory_order_release);
+	box.m_task_cancelled.store(false, std::memory_order_release);
+
+	task_cell new_task;
+	force_make_task_sub(new_task, &box, std::forward<function_Ty>(task), std::forward<_Args>(args)...);
+
+#ifdef WELP_THREADS_DEBUG_MODE
+	if (!push_task_sub(new_task, 0))
+	{
+		m_DEBUG_record_delayed_task_count.fetch_add(1, std::memory_order_relaxed);
+	}
+	else { return; }
+#endif // WELP_THREADS_DEBUG_MODE
+	force_push_task_sub(new_task, 0);
+}
+
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class return_Ty, class box_wait_Ty, class function_Ty, class ... _Args>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::async_task(welp::async_task_result<return_Ty, box_wait_Ty>& box, function_Ty&& task, _Args&& ... args)
+{
+	if (!box.m_task_running.load(std::memory_order_acquire))
+	{
+		box.m_task_running.store(true, std::memory_order_release);
+		box.m_task_denied.store(false, std::memory_order_release);
+		box.m_task_cancelled.store(false, std::memory_order_release);
+		box.m_continuation_ptr.store(nullptr, std::memory_order_relaxed);
+
+		task_cell new_task;
+		if (make_task_sub(new_task, &box, std::forward<function_Ty>(task), std::forward<_Args>(args)...) && push_task_sub(new_task, m_number_of_levels - 1))
+		{
+			return true;
+		}
+
+		box.m_continuation_ptr.store(welp::threads_continuation::unbound(), std::memory_order_relaxed);
+		box.m_task_running.store(false, std::memory_order_release);
+	}
+
+	box.m_task_denied.store(true, std::memory_order_release);
+
+#ifdef WELP_THREADS_DEBUG_MODE
+	if (m_DEBUG_record_on)
+	{
+		m_DEBUG_record_denied_task_count.fetch_add(1);
+	}
+#endif // WELP_THREADS_DEBUG_MODE
+
+	return false;
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class return_Ty, class box_wait_Ty, class function_Ty, class ... _Args>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::force_async_task(welp::async_task_result<return_Ty, box_wait_Ty>& box, function_Ty&& task, _Args&& ... args)
+{
+	box_wait_Ty::wait_until(&box.m_task_running, [&box]() { return !box.m_task_running.load(std::memory_order_acquire); });
+	box.m_task_running.store(true, std::memory_order_release);
+	box.m_task_denied.store(false, std::memory_order_release);
+	box.m_task_cancelled.store(false, std::memory_order_release);
+	box.m_continuation_ptr.store(nullptr, std::memory_order_relaxed);
+
+	task_cell new_task;
+	force_make_task_sub(new_task, &box, std::forward<function_Ty>(task), std::forward<_Args>(args)...);
+
+#ifdef WELP_THREADS_DEBUG_MODE
+	if (!push_task_sub(new_task, m_number_of_levels - 1))
+	{
+		m_DEBUG_record_delayed_task_count.fetch_add(1, std::memory_order_relaxed);
+	}
+	else { return; }
+#endif // WELP_THREADS_DEBUG_MODE
+	force_push_task_sub(new_task, m_number_of_levels - 1);
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class return_Ty, class box_wait_Ty, class function_Ty, class ... _Args>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::priority_async_task(welp::async_task_result<return_Ty, box_wait_Ty>& box, function_Ty&& task, _Args&& ... args)
+{
+	if (!box.m_task_running.load(std::memory_order_acquire))
+	{
+		box.m_task_running.store(true, std::memory_order_release);
+		box.m_task_denied.store(false, std::memory_order_release);
+		box.m_task_cancelled.store(false, std::memory_order_release);
+		box.m_continuation_ptr.store(nullptr, std::memory_order_relaxed);
+
+		task_cell new_task;
+		if (make_task_sub(new_task, &box, std::forward<function_Ty>(task), std::forward<_Args>(args)...) && push_task_sub(new_task, 0))
+		{
+			return true;
+		}
+
+		box.m_continuation_ptr.store(welp::threads_continuation::unbound(), std::memory_order_relaxed);
+		box.m_task_running.store(false, std::memory_order_release);
+	}
+
+	box.m_task_denied.store(true, std::memory_order_release);
+
+#ifdef WELP_THREADS_DEBUG_MODE
+	if (m_DEBUG_record_on)
+	{
+		m_DEBUG_record_denied_task_count.fetch_add(1);
+	}
+#endif // WELP_THREADS_DEBUG_MODE
+
+	return false;
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class return_Ty, class box_wait_Ty, class function_Ty, class ... _Args>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::force_priority_async_task(welp::async_task_result<return_Ty, box_wait_Ty>& box, function_Ty&& task, _Args&& ... args)
+{
+	box_wait_Ty::wait_until(&box.m_task_running, [&box]() { return !box.m_task_running.load(std::memory_order_acquire); });
+	box.m_task_running.store(true, std::memory_order_release);
+	box.m_task_denied.store(false, std::memory_order_release);
+	box.m_task_cancelled.store(false, std::memory_order_release);
+	box.m_continuation_ptr.store(nullptr, std::memory_order_relaxed);
+
+	task_cell new_task;
+	force_make_task_sub(new_task, &box, std::forward<function_Ty>(task), std::forward<_Args>(args)...);
+
+#ifdef WELP_THREADS_DEBUG_MODE
+	if (!push_task_sub(new_task, 0))
+	{
+		m_DEBUG_record_delayed_task_count.fetch_add(1, std::memory_order_relaxed);
+	}
+	else { return; }
+#endif // WELP_THREADS_DEBUG_MODE
+	force_push_task_sub(new_task, 0);
+}
+
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class group_wait_Ty, class function_Ty, class ... _Args>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::async_task(welp::basic_task_group<group_wait_Ty>& group, function_Ty&& task, _Args&& ... args)
+{
+	group.add_count(1);
+
+	task_cell new_task;
+	if (make_task_sub(new_task, &group, std::forward<function_Ty>(task), std::forward<_Args>(args)...) && push_task_sub(new_task, m_number_of_levels - 1))
+	{
+		return true;
+	}
+
+	group.count_down();
+
+#ifdef WELP_THREADS_DEBUG_MODE
+	if (m_DEBUG_record_on)
+	{
+		m_DEBUG_record_denied_task_count.fetch_add(1);
+	}
+#endif // WELP_THREADS_DEBUG_MODE
+
+	return false;
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class group_wait_Ty, class function_Ty, class ... _Args>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::force_async_task(welp::basic_task_group<group_wait_Ty>& group, function_Ty&& task, _Args&& ... args)
+{
+	group.add_count(1);
+
+	task_cell new_task;
+	force_make_task_sub(new_task, &group, std::forward<function_Ty>(task), std::forward<_Args>(args)...);
+
+#ifdef WELP_THREADS_DEBUG_MODE
+	if (!push_task_sub(new_task, m_number_of_levels - 1))
+	{
+		m_DEBUG_record_delayed_task_count.fetch_add(1, std::memory_order_relaxed);
+	}
+	else { return; }
+#endif // WELP_THREADS_DEBUG_MODE
+	force_push_task_sub(new_task, m_number_of_levels - 1);
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class group_wait_Ty, class function_Ty, class ... _Args>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::priority_async_task(welp::basic_task_group<group_wait_Ty>& group, function_Ty&& task, _Args&& ... args)
+{
+	group.add_count(1);
+
+	task_cell new_task;
+	if (make_task_sub(new_task, &group, std::forward<function_Ty>(task), std::forward<_Args>(args)...) && push_task_sub(new_task, 0))
+	{
+		return true;
+	}
+
+	group.count_down();
+
+#ifdef WELP_THREADS_DEBUG_MODE
+	if (m_DEBUG_record_on)
+	{
+		m_DEBUG_record_denied_task_count.fetch_add(1);
+	}
+#endif // WELP_THREADS_DEBUG_MODE
+
+	return false;
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class group_wait_Ty, class function_Ty, class ... _Args>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::force_priority_async_task(welp::basic_task_group<group_wait_Ty>& group, function_Ty&& task, _Args&& ... args)
+{
+	group.add_count(1);
+
+	task_cell new_task;
+	force_make_task_sub(new_task, &group, std::forward<function_Ty>(task), std::forward<_Args>(args)...);
+
+#ifdef WELP_THREADS_DEBUG_MODE
+	if (!push_task_sub(new_task, 0))
+	{
+		m_DEBUG_record_delayed_task_count.fetch_add(1, std::memory_order_relaxed);
+	}
+	else { return; }
+#endif // WELP_THREADS_DEBUG_MODE
+	force_push_task_sub(new_task, 0);
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class function_Ty, class ... _Args>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::async_task(welp::threads_priority priority, function_Ty&& task, _Args&& ... args)
+{
+	task_cell new_task;
+	if (make_task_sub(new_task, nullptr, std::forward<function_Ty>(task), std::forward<_Args>(args)...) && push_task_sub(new_task, level_sub(priority)))
+	{
+		return true;
+	}
+	else
+	{
+#ifdef WELP_THREADS_DEBUG_MODE
+		if (m_DEBUG_record_on)
+		{
+			m_DEBUG_record_denied_task_count.fetch_add(1);
+		}
+#endif // WELP_THREADS_DEBUG_MODE
+
+		return false;
+	}
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class function_Ty, class ... _Args>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::force_async_task(welp::threads_priority priority, function_Ty&& task, _Args&& ... args)
+{
+	task_cell new_task;
+	force_make_task_sub(new_task, nullptr, std::forward<function_Ty>(task), std::forward<_Args>(args)...);
+
+#ifdef WELP_THREADS_DEBUG_MODE
+	if (!push_task_sub(new_task, level_sub(priority)))
+	{
+		m_DEBUG_record_delayed_task_count.fetch_add(1);
+	}
+	else { return; }
+#endif // WELP_THREADS_DEBUG_MODE
+	force_push_task_sub(new_task, level_sub(priority));
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class box_wait_Ty, class function_Ty, class ... _Args>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::async_task(welp::threads_priority priority, welp::basic_async_task_end<box_wait_Ty>& box, function_Ty&& task, _Args&& ... args)
+{
+	if (!box.m_task_running.load(std::memory_order_acquire))
+	{
+		box.m_task_running.store(true, std::memory_order_release);
+		box.m_task_denied.store(false, std::memory_order_release);
+		box.m_task_cancelled.store(false, std::memory_order_release);
+
+		task_cell new_task;
+		if (make_task_sub(new_task, &box, std::forward<function_Ty>(task), std::forward<_Args>(args)...) && push_task_sub(new_task, level_sub(priority)))
+		{
+			return true;
+		}
+
+		box.m_task_running.store(false, std::memory_order_release);
+	}
+
+	box.m_task_denied.store(true, std::memory_order_release);
+
+#ifdef WELP_THREADS_DEBUG_MODE
+	if (m_DEBUG_record_on)
+	{
+		m_DEBUG_record_denied_task_count.fetch_add(1);
+	}
+#endif // WELP_THREADS_DEBUG_MODE
+
+	return false;
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class box_wait_Ty, class function_Ty, class ... _Args>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::force_async_task(welp::threads_priority priority, welp::basic_async_task_end<box_wait_Ty>& box, function_Ty&& task, _Args&& ... args)
+{
+	box_wait_Ty::wait_until(&box.m_task_running, [&box]() { return !box.m_task_running.load(std::memory_order_acquire); });
+	box.m_task_running.store(true, std::memory_order_release);
+	box.m_task_denied.store(false, std::memory_order_release);
+	box.m_task_cancelled.store(false, std::memory_order_release);
+
+	task_cell new_task;
+	force_make_task_sub(new_task, &box, std::forward<function_Ty>(task), std::forward<_Args>(args)...);
+
+#ifdef WELP_THREADS_DEBUG_MODE
+	if (!push_task_sub(new_task, level_sub(priority)))
+	{
+		m_DEBUG_record_delayed_task_count.fetch_add(1, std::memory_order_relaxed);
+	}
+	else { return; }
+#endif // WELP_THREADS_DEBUG_MODE
+	force_push_task_sub(new_task, level_sub(priority));
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class return_Ty, class box_wait_Ty, class function_Ty, class ... _Args>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::async_task(welp::threads_priority priority, welp::async_task_result<return_Ty, box_wait_Ty>& box, function_Ty&& task, _Args&& ... args)
+{
+	if (!box.m_task_running.load(std::memory_order_acquire))
+	{
+		box.m_task_running.store(true, std::memory_order_release);
+		box.m_task_denied.store(false, std::memory_order_release);
+		box.m_task_cancelled.store(false, std::memory_order_release);
+		box.m_continuation_ptr.store(nullptr, std::memory_order_relaxed);
+
+		task_cell new_task;
+		if (make_task_sub(new_task, &box, std::forward<function_Ty>(task), std::forward<_Args>(args)...) && push_task_sub(new_task, level_sub(priority)))
+		{
+			return true;
+		}
+
+		box.m_continuation_ptr.store(welp::threads_continuation::unbound(), std::memory_order_relaxed);
+		box.m_task_running.store(false, std::memory_order_release);
+	}
+
+	box.m_task_denied.store(true, std::memory_order_release);
+
+#ifdef WELP_THREADS_DEBUG_MODE
+	if (m_DEBUG_record_on)
+	{
+		m_DEBUG_record_denied_task_count.fetch_add(1);
+	}
+#endif // WELP_THREADS_DEBUG_MODE
+
+	return false;
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class return_Ty, class box_wait_Ty, class function_Ty, class ... _Args>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::force_async_task(welp::threads_priority priority, welp::async_task_result<return_Ty, box_wait_Ty>& box, function_Ty&& task, _Args&& ... args)
+{
+	box_wait_Ty::wait_until(&box.m_task_running, [&box]() { return !box.m_task_running.load(std::memory_order_acquire); });
+	box.m_task_running.store(true, std::memory_order_release);
+	box.m_task_denied.store(false, std::memory_order_release);
+	box.m_task_cancelled.store(false, std::memory_order_release);
+	box.m_continuation_ptr.store(nullptr, std::memory_order_relaxed);
+
+	task_cell new_task;
+	force_make_task_sub(new_task, &box, std::forward<function_Ty>(task), std::forward<_Args>(args)...);
+
+#ifdef WELP_THREADS_DEBUG_MODE
+	if (!push_task_sub(new_task, level_sub(priority)))
+	{
+		m_DEBUG_record_delayed_task_count.fetch_add(1, std::memory_order_relaxed);
+	}
+	else { return; }
+#endif // WELP_THREADS_DEBUG_MODE
+	force_push_task_sub(new_task, level_sub(priority));
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class group_wait_Ty, class function_Ty, class ... _Args>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::async_task(welp::threads_priority priority, welp::basic_task_group<group_wait_Ty>& group, function_Ty&& task, _Args&& ... args)
+{
+	group.add_count(1);
+
+	task_cell new_task;
+	if (make_task_sub(new_task, &group, std::forward<function_Ty>(task), std::forward<_Args>(args)...) && push_task_sub(new_task, level_sub(priority)))
+	{
+		return true;
+	}
+
+	group.count_down();
+
+#ifdef WELP_THREADS_DEBUG_MODE
+	if (m_DEBUG_record_on)
+	{
+		m_DEBUG_record_denied_task_count.fetch_add(1);
+	}
+#endif // WELP_THREADS_DEBUG_MODE
+
+	return false;
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class group_wait_Ty, class function_Ty, class ... _Args>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::force_async_task(welp::threads_priority priority, welp::basic_task_group<group_wait_Ty>& group, function_Ty&& task, _Args&& ... args)
+{
+	group.add_count(1);
+
+	task_cell new_task;
+	force_make_task_sub(new_task, &group, std::forward<function_Ty>(task), std::forward<_Args>(args)...);
+
+#ifdef WELP_THREADS_DEBUG_MODE
+	if (!push_task_sub(new_task, level_sub(priority)))
+	{
+		m_DEBUG_record_delayed_task_count.fetch_add(1, std::memory_order_relaxed);
+	}
 	else { return; }
 #endif // WELP_THREADS_DEBUG_MODE
-	while (!force_async_task_sub(task, std::forward<_Args>(args)...)) {}
+	force_push_task_sub(new_task, level_sub(priority));
+}
+
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class function_Ty, class ... _Args>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::async_task(welp::task_cancellation cancellation, function_Ty&& task, _Args&& ... args)
+{
+	return async_task(cancellable_task_type<function_Ty, void>(std::forward<function_Ty>(task), cancellation, nullptr), std::forward<_Args>(args)...);
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class function_Ty, class ... _Args>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::force_async_task(welp::task_cancellation cancellation, function_Ty&& task, _Args&& ... args)
+{
+	force_async_task(cancellable_task_type<function_Ty, void>(std::forward<function_Ty>(task), cancellation, nullptr), std::forward<_Args>(args)...);
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class box_wait_Ty, class function_Ty, class ... _Args>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::async_task(welp::task_cancellation cancellation, welp::basic_async_task_end<box_wait_Ty>& box, function_Ty&& task, _Args&& ... args)
+{
+	return async_task(box, cancellable_task_type<function_Ty, void>(std::forward<function_Ty>(task), cancellation, &box.m_task_cancelled), std::forward<_Args>(args)...);
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class box_wait_Ty, class function_Ty, class ... _Args>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::force_async_task(welp::task_cancellation cancellation, welp::basic_async_task_end<box_wait_Ty>& box, function_Ty&& task, _Args&& ... args)
+{
+	force_async_task(box, cancellable_task_type<function_Ty, void>(std::forward<function_Ty>(task), cancellation, &box.m_task_cancelled), std::forward<_Args>(args)...);
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class return_Ty, class box_wait_Ty, class function_Ty, class ... _Args>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::async_task(welp::task_cancellation cancellation, welp::async_task_result<return_Ty, box_wait_Ty>& box, function_Ty&& task, _Args&& ... args)
+{
+	return async_task(box, cancellable_task_type<function_Ty, return_Ty>(std::forward<function_Ty>(task), cancellation, &box.m_task_cancelled), std::forward<_Args>(args)...);
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class return_Ty, class box_wait_Ty, class function_Ty, class ... _Args>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::force_async_task(welp::task_cancellation cancellation, welp::async_task_result<return_Ty, box_wait_Ty>& box, function_Ty&& task, _Args&& ... args)
+{
+	force_async_task(box, cancellable_task_type<function_Ty, return_Ty>(std::forward<function_Ty>(task), cancellation, &box.m_task_cancelled), std::forward<_Args>(args)...);
+}
+
+// a dropped task still counts down the group
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class group_wait_Ty, class function_Ty, class ... _Args>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::async_task(welp::task_cancellation cancellation, welp::basic_task_group<group_wait_Ty>& group, function_Ty&& task, _Args&& ... args)
+{
+	return async_task(group, cancellable_task_type<function_Ty, void>(std::forward<function_Ty>(task), cancellation, nullptr), std::forward<_Args>(args)...);
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class group_wait_Ty, class function_Ty, class ... _Args>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::force_async_task(welp::task_cancellation cancellation, welp::basic_task_group<group_wait_Ty>& group, function_Ty&& task, _Args&& ... args)
+{
+	force_async_task(group, cancellable_task_type<function_Ty, void>(std::forward<function_Ty>(task), cancellation, nullptr), std::forward<_Args>(args)...);
+}
+
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class clock_Ty, class duration_Ty, class function_Ty, class ... _Args>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::async_task_at(const std::chrono::time_point<clock_Ty, duration_Ty>& time_point, function_Ty&& task, _Args&& ... args)
+{
+	return async_task_after(time_point - clock_Ty::now(), std::forward<function_Ty>(task), std::forward<_Args>(args)...);
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class rep_Ty, class period_Ty, class function_Ty, class ... _Args>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::async_task_after(const std::chrono::duration<rep_Ty, period_Ty>& delay, function_Ty&& task, _Args&& ... args)
+{
+	if (!owns_resources())
+	{
+		return false;
+	}
+
+	timed_node* node_ptr = static_cast<timed_node*>(static_cast<void*>(this->allocate(sizeof(timed_node))));
+	if (node_ptr == nullptr)
+	{
+		return false;
+	}
+	new (node_ptr) timed_node();
+
+	if (!make_task_sub(node_ptr->m_task, nullptr, std::forward<function_Ty>(task), std::forward<_Args>(args)...))
+	{
+		delete_timed_node_sub(node_ptr);
+		return false;
+	}
+	node_ptr->m_deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(delay);
+
+	return schedule_sub(node_ptr);
+}
+
+// the first run happens one period after the call, a run starts at most once per period and never overlaps the previous one
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class box_wait_Ty, class rep_Ty, class period_Ty, class function_Ty, class ... _Args>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::async_task_every(welp::basic_recurring_task<box_wait_Ty>& box, const std::chrono::duration<rep_Ty, period_Ty>& period,
+	function_Ty&& task, _Args&& ... args)
+{
+	std::chrono::steady_clock::duration steady_period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(period);
+	if (!owns_resources() || box.m_scheduled.load(std::memory_order_acquire) || (steady_period.count() <= 0))
+	{
+		return false;
+	}
+
+	timed_node* node_ptr = static_cast<timed_node*>(static_cast<void*>(this->allocate(sizeof(timed_node))));
+	if (node_ptr == nullptr)
+	{
+		return false;
+	}
+	new (node_ptr) timed_node();
+
+	try
+	{
+		node_ptr->m_task.store(repeated_task_type<function_Ty, _Args...>(std::forward<function_Ty>(task), std::forward<_Args>(args)...),
+			static_cast<_Allocator&>(*this));
+	}
+	catch (...)
+	{
+		delete_timed_node_sub(node_ptr);
+		return false;
+	}
+	node_ptr->m_deadline = std::chrono::steady_clock::now() + steady_period;
+	node_ptr->m_period = steady_period;
+	node_ptr->m_box_ptr = &box;
+	node_ptr->m_finish_ptr = &finish_recurring_sub<box_wait_Ty>;
+
+	box.m_cancel_ptr = &cancel_recurring_sub<box_wait_Ty>;
+	box.m_pool_ptr = this;
+	box.m_node_ptr = node_ptr;
+	box.m_scheduled.store(true, std::memory_order_release);
+
+	return schedule_sub(node_ptr);
+}
+
+// tasks waiting for their deadline, not counted by waiting_task_count and not waited for by finish_all_tasks
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+inline std::size_t welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::timed_task_count() const noexcept
+{
+	return m_timed_task_count.load();
+}
+
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class rep_Ty, class period_Ty, class function_Ty, class ... _Args>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::try_async_task_for(const std::chrono::duration<rep_Ty, period_Ty>& timeout, function_Ty&& task, _Args&& ... args)
+{
+	return try_async_task_for(welp::threads_priority(m_number_of_levels - 1), timeout, std::forward<function_Ty>(task), std::forward<_Args>(args)...);
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class rep_Ty, class period_Ty, class function_Ty, class ... _Args>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::try_async_task_for(welp::threads_priority priority, const std::chrono::duration<rep_Ty, period_Ty>& timeout, function_Ty&& task, _Args&& ... args)
+{
+	std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(timeout);
+
+	task_cell new_task;
+	if (make_task_sub(new_task, nullptr, std::forward<function_Ty>(task), std::forward<_Args>(args)...)
+		&& push_task_until_sub(new_task, level_sub(priority), deadline))
+	{
+		return true;
+	}
+
+#ifdef WELP_THREADS_DEBUG_MODE
+	if (m_DEBUG_record_on)
+	{
+		m_DEBUG_record_denied_task_count.fetch_add(1);
+	}
+#endif // WELP_THREADS_DEBUG_MODE
+
+	return false;
+}
+
+// the policy can only be changed while T owns no threads
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::set_overflow_policy(welp::threads_overflow policy) noexcept
+{
+	if (owns_resources())
+	{
+		return false;
+	}
+	m_overflow_policy = policy;
+	return true;
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+inline std::size_t welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::spilled_task_count() const noexcept
+{
+	return m_spilled_tasks.load();
+}
+
+
+// the counters of the threads are always recorded, the clock is only read while telemetry is on
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::set_telemetry(bool enable) noexcept
+{
+	m_telemetry_on.store(enable, std::memory_order_relaxed);
+}
+
+// sums the counters of every slot, including the slots of retired threads
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+welp::threads_snapshot welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::snapshot() const noexcept
+{
+	welp::threads_snapshot stats;
+	stats.number_of_threads = m_number_of_threads.load();
+	stats.waiting_tasks = m_waiting_tasks.load();
+	stats.unfinished_tasks = m_unfinished_tasks.load();
+	stats.timed_tasks = m_timed_task_count.load();
+	for (std::size_t k = 0; (k < m_thread_capacity) && (m_worker_stats_ptr != nullptr); k++)
+	{
+		add_stats_sub(stats, k);
+	}
+	return stats;
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+welp::threads_snapshot welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::snapshot(std::size_t thread_number) const noexcept
+{
+	welp::threads_snapshot stats;
+	stats.number_of_threads = m_number_of_threads.load();
+	stats.waiting_tasks = m_waiting_tasks.load();
+	stats.unfinished_tasks = m_unfinished_tasks.load();
+	stats.timed_tasks = m_timed_task_count.load();
+	if ((thread_number < m_thread_capacity) && (m_worker_stats_ptr != nullptr))
+	{
+		add_stats_sub(stats, thread_number);
+	}
+	return stats;
+}
+
+
+#ifdef WELP_THREADS_COROUTINES
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+inline typename welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::schedule_awaiter welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::schedule() noexcept
+{
+	return schedule_awaiter(this, m_number_of_levels - 1);
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+inline typename welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::schedule_awaiter welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::schedule(welp::threads_priority priority) noexcept
+{
+	return schedule_awaiter(this, level_sub(priority));
+}
+
+// the awaiter lives in the frame of the coroutine, it must not be touched once the task is queued,
+// a full buffer is rejected whatever the overflow policy so that the coroutine goes on in the calling thread instead of resuming inside await_suspend
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+inline bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::schedule_awaiter::await_suspend(std::coroutine_handle<> handle) noexcept
+{
+	m_scheduled = true;
+	task_cell new_task;
+	if (m_pool_ptr->make_task_sub(new_task, nullptr, [handle]() { handle.resume(); })
+		&& m_pool_ptr->push_task_sub(new_task, m_level, welp::threads_overflow::reject))
+	{
+		return true;
+	}
+	m_scheduled = false;
+	return false;
+}
+#endif // WELP_THREADS_COROUTINES
+
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class value_Ty, class value_wait_Ty, class function_Ty>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::then(welp::async_task_result<value_Ty, value_wait_Ty>& box, function_Ty&& task)
+{
+	return then_sub(box, nullptr, std::forward<function_Ty>(task));
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class value_Ty, class value_wait_Ty, class box_wait_Ty, class function_Ty>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::then(welp::async_task_result<value_Ty, value_wait_Ty>& box, welp::basic_async_task_end<box_wait_Ty>& next_box, function_Ty&& task)
+{
+	if (!next_box.m_task_running.load(std::memory_order_acquire))
+	{
+		next_box.m_task_running.store(true, std::memory_order_release);
+		next_box.m_task_denied.store(false, std::memory_order_release);
+		next_box.m_task_cancelled.store(false, std::memory_order_release);
+
+		if (then_sub(box, &next_box, std::forward<function_Ty>(task)))
+		{
+			return true;
+		}
+
+		next_box.m_task_running.store(false, std::memory_order_release);
+	}
+
+	next_box.m_task_denied.store(true, std::memory_order_release);
+	return false;
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class value_Ty, class value_wait_Ty, class return_Ty, class box_wait_Ty, class function_Ty>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::then(welp::async_task_result<value_Ty, value_wait_Ty>& box, welp::async_task_result<return_Ty, box_wait_Ty>& next_box, function_Ty&& task)
+{
+	if (!next_box.m_task_running.load(std::memory_order_acquire))
+	{
+		next_box.m_task_running.store(true, std::memory_order_release);
+		next_box.m_task_denied.store(false, std::memory_order_release);
+		next_box.m_task_cancelled.store(false, std::memory_order_release);
+		next_box.m_continuation_ptr.store(nullptr, std::memory_order_relaxed);
+
+		if (then_sub(box, &next_box, std::forward<function_Ty>(task)))
+		{
+			return true;
+		}
+
+		next_box.m_continuation_ptr.store(welp::threads_continuation::unbound(), std::memory_order_relaxed);
+		next_box.m_task_running.store(false, std::memory_order_release);
+	}
+
+	next_box.m_task_denied.store(true, std::memory_order_release);
+	return false;
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class value_Ty, class value_wait_Ty, class group_wait_Ty, class function_Ty>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::then(welp::async_task_result<value_Ty, value_wait_Ty>& box, welp::basic_task_group<group_wait_Ty>& group, function_Ty&& task)
+{
+	group.add_count(1);
+	if (then_sub(box, &group, std::forward<function_Ty>(task)))
+	{
+		return true;
+	}
+	group.count_down();
+	return false;
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class value_Ty, class value_wait_Ty, class target_ptr_Ty, class function_Ty>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::then_sub(welp::async_task_result<value_Ty, value_wait_Ty>& box, target_ptr_Ty target_ptr, function_Ty&& task)
+{
+	using node_Ty = continuation_node<value_Ty, target_ptr_Ty, typename std::decay<function_Ty>::type>;
+
+	// no threads to run the continuation
+	if (m_task_ring.capacity() == 0)
+	{
+		return false;
+	}
+
+	node_Ty* node_ptr = static_cast<node_Ty*>(static_cast<void*>(this->allocate(sizeof(node_Ty))));
+	if (node_ptr == nullptr)
+	{
+		return false;
+	}
+	try
+	{
+		new (node_ptr) node_Ty(this, target_ptr, std::forward<function_Ty>(task));
+	}
+	catch (...)
+	{
+		this->deallocate(static_cast<char*>(static_cast<void*>(node_ptr)), sizeof(node_Ty));
+		return false;
+	}
+
+	welp::threads_continuation* head_ptr = box.m_continuation_ptr.load(std::memory_order_acquire);
+	while (true)
+	{
+		if (head_ptr == welp::threads_continuation::unbound())
+		{
+			node_ptr->~node_Ty();
+			this->deallocate(static_cast<char*>(static_cast<void*>(node_ptr)), sizeof(node_Ty));
+			return false;
+		}
+		if (head_ptr == welp::threads_continuation::finished())
+		{
+			// the task of box is already finished
+			node_ptr->m_launch_ptr(node_ptr, &box.m_stored_value);
+			return true;
+		}
+		node_ptr->m_next_ptr = head_ptr;
+		if (box.m_continuation_ptr.compare_exchange_weak(head_ptr, node_ptr, std::memory_order_acq_rel, std::memory_order_acquire))
+		{
+			return true;
+		}
+	}
+}
+
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class iterator_Ty, class function_Ty>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::async_batch(iterator_Ty first, iterator_Ty last, function_Ty&& task)
+{
+	return async_batch_sub(static_cast<welp::basic_async_task_end<wait_Ty>*>(nullptr), first, last, std::forward<function_Ty>(task));
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class box_wait_Ty, class iterator_Ty, class function_Ty>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::async_batch(welp::basic_async_task_end<box_wait_Ty>& box, iterator_Ty first, iterator_Ty last, function_Ty&& task)
+{
+	if (!box.m_task_running.load(std::memory_order_acquire))
+	{
+		box.m_task_running.store(true, std::memory_order_release);
+		box.m_task_denied.store(false, std::memory_order_release);
+		box.m_task_cancelled.store(false, std::memory_order_release);
+
+		if (async_batch_sub(&box, first, last, std::forward<function_Ty>(task)))
+		{
+			return true;
+		}
+
+		box.m_task_running.store(false, std::memory_order_release);
+	}
+
+	box.m_task_denied.store(true, std::memory_order_release);
+	return false;
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class box_wait_Ty, class iterator_Ty, class function_Ty>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::async_batch_sub(welp::basic_async_task_end<box_wait_Ty>* box_ptr, iterator_Ty first, iterator_Ty last, function_Ty&& task)
+{
+	using state_Ty = batch_state<typename std::decay<function_Ty>::type, box_wait_Ty, true>;
+	using batch_task_Ty = batch_task<iterator_Ty, state_Ty>;
+	static_assert(sizeof(batch_task_Ty) <= task_cell_size, "welp::threads : iterator too big for task_cell_size");
+	static_assert(std::is_nothrow_copy_constructible<iterator_Ty>::value, "welp::threads : iterator copy may throw");
+
+	std::size_t count = static_cast<std::size_t>(std::distance(first, last));
+	if (count == 0)
+	{
+		if (box_ptr != nullptr) { box_ptr->m_task_running.store(false, std::memory_order_release); }
+		return true;
+	}
+
+	state_Ty* state_ptr = static_cast<state_Ty*>(static_cast<void*>(this->allocate(sizeof(state_Ty))));
+	if (state_ptr != nullptr)
+	{
+		bool state_created = false;
+		try
+		{
+			new (state_ptr) state_Ty(std::forward<function_Ty>(task), count, box_ptr, static_cast<_Allocator*>(this));
+			state_created = true;
+		}
+		catch (...) {}
+
+		if (state_created)
+		{
+			if (push_block_sub(count, [&](task_cell& new_task)
+				{
+					new_task.store(batch_task_Ty(first, state_ptr), static_cast<_Allocator&>(*this));
+					++first;
+				}))
+			{
+				return true;
+			}
+			state_ptr->~state_Ty();
+		}
+		this->deallocate(static_cast<char*>(static_cast<void*>(state_ptr)), sizeof(state_Ty));
+	}
+
+#ifdef WELP_THREADS_DEBUG_MODE
+	if (m_DEBUG_record_on)
+	{
+		m_DEBUG_record_denied_task_count.fetch_add(static_cast<WELP_THREADS_RECORD_INT>(count));
+	}
+#endif // WELP_THREADS_DEBUG_MODE
+
+	return false;
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class index_Ty, class function_Ty>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::parallel_for(index_Ty begin, index_Ty end, index_Ty grain, function_Ty&& task)
+{
+	using state_Ty = batch_state<typename std::remove_reference<function_Ty>::type&, wait_Ty, false>;
+	using range_task_Ty = range_task<index_Ty, state_Ty>;
+	static_assert(sizeof(range_task_Ty) <= task_cell_size, "welp::threads : index type too big for task_cell_size");
+
+	if (!(begin < end)) { return; }
+	if (grain < static_cast<index_Ty>(1)) { grain = static_cast<index_Ty>(1); }
+
+	std::size_t remaining_chunks = static_cast<std::size_t>((end - begin) / grain)
+		+ static_cast<std::size_t>(((end - begin) % grain) != static_cast<index_Ty>(0));
+	state_Ty state(task, remaining_chunks, nullptr, nullptr);
+
+	index_Ty chunk_begin = begin;
+	std::size_t block_size = remaining_chunks;
+	while (remaining_chunks != 0)
+	{
+		if (block_size > remaining_chunks) { block_size = remaining_chunks; }
+		if (push_block_sub(block_size, [&](task_cell& new_task)
+			{
+				index_Ty chunk_end = (end - chunk_begin > grain) ? chunk_begin + grain : end;
+				new_task.store(range_task_Ty(chunk_begin, chunk_end, &state), static_cast<_Allocator&>(*this));
+				chunk_begin = chunk_end;
+			}))
+		{
+			remaining_chunks -= block_size;
+		}
+		else if (block_size > 1)
+		{
+			block_size /= 2;
+		}
+		else
+		{
+			// the queue is full, the calling thread takes the chunk
+			index_Ty chunk_end = (end - chunk_begin > grain) ? chunk_begin + grain : end;
+			try
+			{
+				range_task_Ty(chunk_begin, chunk_end, &state)();
+			}
+			catch (...)
+			{
+				// the chunks left and the throwing one never finish, the queued chunks still use state until they are done
+				state.m_remaining_tasks.fetch_sub(remaining_chunks, std::memory_order_acq_rel);
+				wait_batch_sub(state.m_remaining_tasks);
+				throw;
+			}
+			chunk_begin = chunk_end;
+			remaining_chunks--;
+		}
+	}
+
+	wait_batch_sub(state.m_remaining_tasks);
+}
+
+// a thread of the pool keeps executing tasks instead of waiting,
+// noexcept so that a task throwing there ends the program like on any thread of the pool instead of leaving the batch state behind
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::wait_batch_sub(const std::atomic<std::size_t>& remaining_tasks) noexcept
+{
+	if (is_local_worker_sub())
+	{
+		task_cell current_task;
+		std::size_t thread_number = local_identity_sub().thread_number;
+		while (remaining_tasks.load(std::memory_order_acquire) != 0)
+		{
+			if (pop_task_sub(current_task, thread_number))
+			{
+				run_task_sub(current_task);
+			}
+			else
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+	else
+	{
+		wait_Ty::wait_until(&remaining_tasks, [&remaining_tasks]() { return remaining_tasks.load(std::memory_order_acquire) == 0; });
+	}
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class iterator_Ty, class value_Ty, class reduce_Ty>
+value_Ty welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::parallel_reduce(iterator_Ty first, iterator_Ty last, value_Ty init, reduce_Ty&& reduce)
+{
+	return parallel_transform_reduce(first, last, std::move(init), std::forward<reduce_Ty>(reduce), identity_transform());
+}
+
+// every chunk is reduced into its own partial, then the partials are reduced in order by the calling thread
+// so that reduce only needs to be associative
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class iterator_Ty, class value_Ty, class reduce_Ty, class transform_Ty>
+value_Ty welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::parallel_transform_reduce(iterator_Ty first, iterator_Ty last, value_Ty init, reduce_Ty&& reduce, transform_Ty&& transform)
+{
+	using partial_Ty = reduce_partial<value_Ty>;
+
+	std::size_t count = (first < last) ? static_cast<std::size_t>(last - first) : 0;
+	std::size_t number_of_chunks = reduce_chunks_sub(count);
+	partial_Ty* partials_ptr = (number_of_chunks > 1) ?
+		static_cast<partial_Ty*>(static_cast<void*>(this->allocate(number_of_chunks * sizeof(partial_Ty)))) : nullptr;
+
+	// too few elements or no memory, the calling thread does it all
+	if (partials_ptr == nullptr)
+	{
+		for (; first < last; ++first)
+		{
+			init = reduce(std::move(init), transform(*first));
+		}
+		return init;
+	}
+
+	parallel_for(static_cast<std::size_t>(0), number_of_chunks, static_cast<std::size_t>(1), [&](std::size_t chunk)
+		{
+			iterator_Ty chunk_first = first + chunk_begin_sub(count, number_of_chunks, chunk);
+			iterator_Ty chunk_last = first + chunk_begin_sub(count, number_of_chunks, chunk + 1);
+			value_Ty* value_ptr = new (static_cast<void*>((partials_ptr + chunk)->m_storage)) value_Ty(transform(*chunk_first));
+			for (++chunk_first; chunk_first < chunk_last; ++chunk_first)
+			{
+				*value_ptr = reduce(std::move(*value_ptr), transform(*chunk_first));
+			}
+		});
+
+	for (std::size_t chunk = 0; chunk < number_of_chunks; chunk++)
+	{
+		value_Ty& value = (partials_ptr + chunk)->value();
+		init = reduce(std::move(init), std::move(value));
+		value.~value_Ty();
+	}
+	this->deallocate(static_cast<char*>(static_cast<void*>(partials_ptr)), number_of_chunks * sizeof(partial_Ty));
+	return init;
+}
+
+// first pass : every chunk but the last is reduced into its partial, the partials are turned into running totals in order,
+// second pass : every chunk is scanned starting from the running total of the chunks before it
+// output may be first for a scan in place
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class input_iterator_Ty, class output_iterator_Ty, class op_Ty>
+output_iterator_Ty welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::parallel_inclusive_scan(input_iterator_Ty first, input_iterator_Ty last, output_iterator_Ty output, op_Ty&& op)
+{
+	using value_Ty = typename std::iterator_traits<input_iterator_Ty>::value_type;
+	using partial_Ty = reduce_partial<value_Ty>;
+
+	std::size_t count = (first < last) ? static_cast<std::size_t>(last - first) : 0;
+	if (count == 0)
+	{
+		return output;
+	}
+	std::size_t number_of_chunks = reduce_chunks_sub(count);
+	partial_Ty* partials_ptr = (number_of_chunks > 1) ?
+		static_cast<partial_Ty*>(static_cast<void*>(this->allocate((number_of_chunks - 1) * sizeof(partial_Ty)))) : nullptr;
+
+	if (partials_ptr == nullptr)
+	{
+		value_Ty total = *first;
+		*output = total;
+		for (std::size_t k = 1; k < count; k++)
+		{
+			total = op(std::move(total), *(first + k));
+			*(output + k) = total;
+		}
+		return output + count;
+	}
+
+	parallel_for(static_cast<std::size_t>(0), number_of_chunks - 1, static_cast<std::size_t>(1), [&](std::size_t chunk)
+		{
+			input_iterator_Ty chunk_first = first + chunk_begin_sub(count, number_of_chunks, chunk);
+			input_iterator_Ty chunk_last = first + chunk_begin_sub(count, number_of_chunks, chunk + 1);
+			value_Ty* value_ptr = new (static_cast<void*>((partials_ptr + chunk)->m_storage)) value_Ty(*chunk_first);
+			for (++chunk_first; chunk_first < chunk_last; ++chunk_first)
+			{
+				*value_ptr = op(std::move(*value_ptr), *chunk_first);
+			}
+		});
+
+	for (std::size_t chunk = 1; chunk < number_of_chunks - 1; chunk++)
+	{
+		(partials_ptr + chunk)->value() = op((partials_ptr + chunk - 1)->value(), std::move((partials_ptr + chunk)->value()));
+	}
+
+	parallel_for(static_cast<std::size_t>(0), number_of_chunks, static_cast<std::size_t>(1), [&](std::size_t chunk)
+		{
+			std::size_t k = chunk_begin_sub(count, number_of_chunks, chunk);
+			std::size_t chunk_end = chunk_begin_sub(count, number_of_chunks, chunk + 1);
+			value_Ty total = (chunk == 0) ? value_Ty(*(first + k)) : op((partials_ptr + chunk - 1)->value(), *(first + k));
+			*(output + k) = total;
+			for (k++; k < chunk_end; k++)
+			{
+				total = op(std::move(total), *(first + k));
+				*(output + k) = total;
+			}
+		});
+
+	for (std::size_t chunk = 0; chunk < number_of_chunks - 1; chunk++)
+	{
+		(partials_ptr + chunk)->value().~value_Ty();
+	}
+	this->deallocate(static_cast<char*>(static_cast<void*>(partials_ptr)), (number_of_chunks - 1) * sizeof(partial_Ty));
+	return output + count;
+}
+
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::finish_all_tasks() noexcept
+{
+	m_waiting_for_finish.store(true, std::memory_order_release);
+	wait_Ty::wait_until(&m_unfinished_tasks, [this]() { return m_unfinished_tasks.load(std::memory_order_acquire) == 0; });
+	m_waiting_for_finish.store(false, std::memory_order_release);
+	wait_Ty::notify_all(&m_waiting_for_finish);
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+inline std::size_t welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::waiting_task_count() const noexcept
+{
+	return m_waiting_tasks.load();
+}
+
+// the tasks of the lowest level waiting in the deques or the node queues are counted with the lowest level
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+inline std::size_t welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::waiting_task_count(std::size_t level) const noexcept
+{
+	if (level + 1 < m_number_of_levels)
+	{
+		return (m_level_rings_ptr != nullptr) ? (m_level_rings_ptr + level)->size() : 0;
+	}
+	else if (level + 1 == m_number_of_levels)
+	{
+		std::size_t lowest_level_count = m_waiting_tasks.load();
+		for (std::size_t n = 0; (n + 1 < m_number_of_levels) && (m_level_rings_ptr != nullptr); n++)
+		{
+			std::size_t level_count = (m_level_rings_ptr + n)->size();
+			lowest_level_count = (lowest_level_count > level_count) ? lowest_level_count - level_count : 0;
+		}
+		return lowest_level_count;
+	}
+	else
+	{
+		return 0;
+	}
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+inline std::size_t welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::unfinished_task_count() const noexcept
+{
+	return m_unfinished_tasks.load();
+}
+
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+inline bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::owns_resources() const noexcept
+{
+	return m_thread_capacity != 0;
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+inline std::size_t welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::number_of_threads() const noexcept
+{
+	return m_number_of_threads.load();
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+inline std::size_t welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::task_buffer_size() const noexcept
+{
+	return m_task_ring.capacity();
+}
+
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+inline std::size_t welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::number_of_priority_levels() const noexcept
+{
+	return m_number_of_levels;
+}
+
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::set_priority_levels(std::size_t number_of_levels, const std::size_t* weights_ptr) noexcept
+{
+	if (owns_resources() || (number_of_levels == 0) || (number_of_levels > WELP_THREADS_MAX_PRIORITY_LEVELS))
+	{
+		return false;
+	}
+
+	std::size_t total_weight = 0;
+	for (std::size_t n = 0; (n < number_of_levels) && (weights_ptr != nullptr); n++)
+	{
+		total_weight += *(weights_ptr + n);
+	}
+	if ((weights_ptr != nullptr) && (total_weight == 0))
+	{
+		return false;
+	}
+
+	m_number_of_levels = number_of_levels;
+	m_total_weight = total_weight;
+	for (std::size_t n = 0; n < WELP_THREADS_MAX_PRIORITY_LEVELS; n++)
+	{
+		m_level_weights[n] = ((weights_ptr != nullptr) && (n < number_of_levels)) ? *(weights_ptr + n) : 0;
+	}
+	return true;
+}
+
+// max_number_of_threads = 0 turns the elastic sizing off
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::set_thread_limits(std::size_t min_number_of_threads, std::size_t max_number_of_threads,
+	std::chrono::milliseconds idle_time) noexcept
+{
+	if (owns_resources() || (min_number_of_threads > max_number_of_threads))
+	{
+		return false;
+	}
+
+	m_min_threads = min_number_of_threads;
+	m_max_threads = max_number_of_threads;
+	m_idle_time = idle_time;
+	return true;
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::new_threads(std::size_t input_number_of_threads, std::size_t input_task_buffer_size)
+{
+	return new_threads_sub(input_number_of_threads, input_task_buffer_size, nullptr);
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::new_threads(std::size_t input_number_of_threads, std::size_t input_task_buffer_size,
+	const welp::threads_affinity& affinity)
+{
+	return new_threads_sub(input_number_of_threads, input_task_buffer_size, affinity.empty() ? nullptr : &affinity);
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::new_threads_sub(std::size_t input_number_of_threads, std::size_t input_task_buffer_size,
+	const welp::threads_affinity* affinity_ptr)
+{
+	delete_threads();
+	m_stop_threads = false;
+
+	if ((input_number_of_threads == 0) || (input_task_buffer_size == 0))
+	{
+		return false;
+	}
+
+	input_task_buffer_size = (input_number_of_threads > input_task_buffer_size) ? input_number_of_threads : input_task_buffer_size;
+
+	try
+	{
+		if (m_number_of_levels > 1)
+		{
+			m_level_rings_ptr = static_cast<task_ring*>(static_cast<void*>(
+				this->allocate((m_number_of_levels - 1) * sizeof(task_ring))));
+			if (m_level_rings_ptr == nullptr) { delete_threads(); return false; }
+			for (std::size_t n = 0; n < m_number_of_levels - 1; n++)
+			{
+				new (m_level_rings_ptr + n) task_ring();
+			}
+			for (std::size_t n = 0; n < m_number_of_levels - 1; n++)
+			{
+				if (!new_ring_sub(*(m_level_rings_ptr + n), input_task_buffer_size)) { delete_threads(); return false; }
+			}
+		}
+		if (!new_ring_sub(m_task_ring, input_task_buffer_size)) { delete_threads(); return false; }
+
+		// room for the threads that add_threads or the elastic sizing may start later
+		std::size_t thread_capacity = static_cast<std::size_t>(std::thread::hardware_concurrency());
+		thread_capacity = (thread_capacity > input_number_of_threads) ? thread_capacity : input_number_of_threads;
+		thread_capacity = (thread_capacity > m_max_threads) ? thread_capacity : m_max_threads;
+
+		if (work_stealing)
+		{
+			m_worker_deques_ptr = static_cast<worker_deque*>(static_cast<void*>(
+				this->allocate(thread_capacity * sizeof(worker_deque))));
+			if (m_worker_deques_ptr == nullptr) { delete_threads(); return false; }
+			for (std::size_t k = 0; k < thread_capacity; k++)
+			{
+				new (m_worker_deques_ptr + k) worker_deque();
+			}
+		}
+
+		if (affinity_ptr != nullptr)
+		{
+			m_affinity_ptr = static_cast<welp::threads_affinity*>(static_cast<void*>(this->allocate(sizeof(welp::threads_affinity))));
+			if (m_affinity_ptr == nullptr) { delete_threads(); return false; }
+			new (m_affinity_ptr) welp::threads_affinity(*affinity_ptr);
+
+			if (affinity_ptr->m_node_queues && (affinity_ptr->m_number_of_nodes > 1))
+			{
+				m_node_rings_ptr = static_cast<task_ring*>(static_cast<void*>(
+					this->allocate(affinity_ptr->m_number_of_nodes * sizeof(task_ring))));
+				if (m_node_rings_ptr == nullptr) { delete_threads(); return false; }
+				for (std::size_t n = 0; n < affinity_ptr->m_number_of_nodes; n++)
+				{
+					new (m_node_rings_ptr + n) task_ring();
+				}
+				m_number_of_nodes = affinity_ptr->m_number_of_nodes;
+				for (std::size_t n = 0; n < m_number_of_nodes; n++)
+				{
+					if (!new_ring_sub(*(m_node_rings_ptr + n), input_task_buffer_size)) { delete_threads(); return false; }
+				}
+			}
+		}
+
+		m_worker_stats_ptr = static_cast<worker_stats*>(static_cast<void*>(
+			this->allocate(thread_capacity * sizeof(worker_stats))));
+		if (m_worker_stats_ptr == nullptr) { delete_threads(); return false; }
+		m_worker_slots_ptr = static_cast<worker_slot*>(static_cast<void*>(
+			this->allocate(thread_capacity * sizeof(worker_slot))));
+		if (m_worker_slots_ptr == nullptr)
+		{
+			this->deallocate(static_cast<char*>(static_cast<void*>(m_worker_stats_ptr)), thread_capacity * sizeof(worker_stats));
+			m_worker_stats_ptr = nullptr;
+			delete_threads(); return false;
+		}
+		for (std::size_t k = 0; k < thread_capacity; k++)
+		{
+			new (m_worker_stats_ptr + k) worker_stats();
+			new (m_worker_slots_ptr + k) worker_slot();
+		}
+		m_thread_capacity = thread_capacity;
+	}
+	catch (...)
+	{
+		delete_threads(); return false;
+	}
+
+	if (m_max_threads != 0)
+	{
+		input_number_of_threads = (input_number_of_threads > m_min_threads) ? input_number_of_threads : m_min_threads;
+		input_number_of_threads = (input_number_of_threads < m_max_threads) ? input_number_of_threads : m_max_threads;
+	}
+
+	std::size_t number_of_new_threads;
+	{
+		std::lock_guard<std::mutex> resize_lock(m_resize_mutex);
+		number_of_new_threads = add_threads_sub(input_number_of_threads, m_thread_capacity);
+	}
+	if (number_of_new_threads != input_number_of_threads)
+	{
+		delete_threads(); return false;
+	}
+
+	return true;
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+std::size_t welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::add_threads(std::size_t number_of_new_threads)
+{
+	std::lock_guard<std::mutex> resize_lock(m_resize_mutex);
+	return add_threads_sub(number_of_new_threads, m_thread_capacity);
+}
+
+// the threads finish their current task before leaving, at least one thread is kept
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+std::size_t welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::retire_threads(std::size_t number_of_retired_threads)
+{
+	{
+		std::lock_guard<std::mutex> resize_lock(m_resize_mutex);
+		std::size_t number_of_threads = m_number_of_threads.load();
+		std::size_t threads_to_retire = m_threads_to_retire.load();
+		std::size_t max_retired_threads = (number_of_threads > threads_to_retire + 1) ? number_of_threads - threads_to_retire - 1 : 0;
+		number_of_retired_threads = (number_of_retired_threads < max_retired_threads) ? number_of_retired_threads : max_retired_threads;
+		m_threads_to_retire.fetch_add(number_of_retired_threads);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+	}
+	m_condition_var.notify_all();
+
+	return number_of_retired_threads;
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::delete_threads() noexcept
+{
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		reinterpret_cast<std::atomic<bool>&>(m_stop_threads).store(true);
+	}
+
+	m_condition_var.notify_all();
+
+	// a thread may be starting another one for the elastic sizing
+	std::lock_guard<std::mutex> resize_lock(m_resize_mutex);
+
+	if (m_worker_slots_ptr != nullptr)
+	{
+		for (size_t k = 0; k < m_thread_capacity; k++)
+		{
+			if ((m_worker_slots_ptr + k)->m_thread.joinable())
+			{
+				(m_worker_slots_ptr + k)->m_thread.join();
+			}
+			(m_worker_slots_ptr + k)->~worker_slot();
+		}
+		this->deallocate(static_cast<char*>(static_cast<void*>(m_worker_slots_ptr)), m_thread_capacity * sizeof(worker_slot));
+
+		for (size_t k = 0; k < m_thread_capacity; k++)
+		{
+			(m_worker_stats_ptr + k)->~worker_stats();
+		}
+		this->deallocate(static_cast<char*>(static_cast<void*>(m_worker_stats_ptr)), m_thread_capacity * sizeof(worker_stats));
+	}
+
+	if (m_worker_deques_ptr != nullptr)
+	{
+		for (size_t k = 0; k < m_thread_capacity; k++)
+		{
+			worker_deque* deque_ptr = m_worker_deques_ptr + k;
+			if (deque_ptr->m_cells_ptr != nullptr)
+			{
+				for (size_t n = 0; n < deque_ptr->m_capacity; n++)
+				{
+					(deque_ptr->m_cells_ptr + n)->~deque_cell();
+				}
+				this->deallocate(static_cast<char*>(static_cast<void*>(deque_ptr->m_cells_ptr)), deque_ptr->m_capacity * sizeof(typename worker_deque::deque_cell));
+			}
+			deque_ptr->~worker_deque();
+		}
+		this->deallocate(static_cast<char*>(static_cast<void*>(m_worker_deques_ptr)), m_thread_capacity * sizeof(worker_deque));
+	}
+
+	delete_spilled_tasks_sub();
+
+	if (m_level_rings_ptr != nullptr)
+	{
+		for (std::size_t n = 0; n < m_number_of_levels - 1; n++)
+		{
+			delete_ring_sub(*(m_level_rings_ptr + n));
+			(m_level_rings_ptr + n)->~task_ring();
+		}
+		this->deallocate(static_cast<char*>(static_cast<void*>(m_level_rings_ptr)), (m_number_of_levels - 1) * sizeof(task_ring));
+	}
+	delete_ring_sub(m_task_ring);
+
+	if (m_node_rings_ptr != nullptr)
+	{
+		for (std::size_t n = 0; n < m_number_of_nodes; n++)
+		{
+			delete_ring_sub(*(m_node_rings_ptr + n));
+			(m_node_rings_ptr + n)->~task_ring();
+		}
+		this->deallocate(static_cast<char*>(static_cast<void*>(m_node_rings_ptr)), m_number_of_nodes * sizeof(task_ring));
+	}
+	// the tasks still waiting for their deadline are dropped and their boxes released
+	if (m_timed_nodes_ptr != nullptr)
+	{
+		std::lock_guard<std::mutex> timer_lock(m_timer_mutex);
+		std::size_t timed_task_count = m_timed_task_count.load();
+		for (std::size_t k = 0; k < timed_task_count; k++)
+		{
+			delete_timed_node_sub(*(m_timed_nodes_ptr + k));
+		}
+		this->deallocate(static_cast<char*>(static_cast<void*>(m_timed_nodes_ptr)), m_timed_nodes_capacity * sizeof(timed_node*));
+		m_timed_nodes_ptr = nullptr;
+		m_timed_nodes_capacity = 0;
+		m_timed_task_count.store(0);
+		m_next_deadline.store(INT64_MAX);
+	}
+	if (m_affinity_ptr != nullptr)
+	{
+		m_affinity_ptr->~threads_affinity();
+		this->deallocate(static_cast<char*>(static_cast<void*>(m_affinity_ptr)), sizeof(welp::threads_affinity));
+	}
+
+	m_worker_slots_ptr = nullptr;
+	m_worker_stats_ptr = nullptr;
+	m_worker_deques_ptr = nullptr;
+	m_level_rings_ptr = nullptr;
+	m_node_rings_ptr = nullptr;
+	m_affinity_ptr = nullptr;
+	m_thread_capacity = 0;
+	m_number_of_threads.store(0);
+	m_threads_to_retire.store(0);
+	m_number_of_nodes = 0;
+}
+
+
+#ifdef WELP_THREADS_DEBUG_MODE
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::DEBUG_reset_record() noexcept
+{
+	m_DEBUG_record_max_occupancy.store(0);
+	m_DEBUG_record_completed_task_count.store(0);
+	m_DEBUG_record_accepted_task_count.store(0);
+	m_DEBUG_record_denied_task_count.store(0);
+	m_DEBUG_record_delayed_task_count.store(0);
+	m_DEBUG_record_on = false;
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::DEBUG_say_sub()
+{
+	std::cout << "\nThreads   > number of threads : " << m_number_of_threads.load()
+		<< "   > task buffer size : " << m_task_ring.capacity()
+		<< "\n          > tasks accepted : " << m_DEBUG_record_accepted_task_count.load()
+		<< "   > tasks accepted with delay : " << m_DEBUG_record_delayed_task_count.load()
+		<< "   > tasks denied : " << m_DEBUG_record_denied_task_count.load()
+		<< "\n          > tasks completed : " << m_DEBUG_record_completed_task_count.load()
+		<< "   > currently unfinished tasks : " << m_unfinished_tasks.load()
+		<< "\n          > maximum occupancy recorded in task buffer : " << m_DEBUG_record_max_occupancy.load() << "\n" << std::endl;
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::DEBUG_say()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	DEBUG_say_sub();
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <typename msg_Ty>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::DEBUG_say(const msg_Ty& msg)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	std::cout << "[ " << msg << " ]\n"; DEBUG_say_sub();
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <typename msg_Ty1, typename msg_Ty2>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::DEBUG_say(const msg_Ty1& msg1, const msg_Ty2& msg2)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	std::cout << "[ " << msg1 << " " << msg2 << " ]\n"; DEBUG_say_sub();
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <typename msg_Ty1, typename msg_Ty2, typename msg_Ty3>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::DEBUG_say(const msg_Ty1& msg1, const msg_Ty2& msg2, const msg_Ty3& msg3)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	std::cout << "[ " << msg1 << " " << msg2 << " " << msg3 << " ]\n"; DEBUG_say_sub();
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <typename msg_Ty1, typename msg_Ty2, typename msg_Ty3, typename msg_Ty4>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::DEBUG_say(const msg_Ty1& msg1, const msg_Ty2& msg2, const msg_Ty3& msg3, const msg_Ty4& msg4)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	std::cout << "[ " << msg1 << " " << msg2 << " " << msg3 << " " << msg4 << " ]\n"; DEBUG_say_sub();
+}
+
+
+#ifdef WELP_THREADS_INCLUDE_FSTREAM
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::DEBUG_write_sub(std::ofstream& rec_write)
+{
+	rec_write << "\nThreads   > number of threads : " << m_number_of_threads.load()
+		<< "   > task buffer size : " << m_task_ring.capacity()
+		<< "\n     > tasks accepted : " << m_DEBUG_record_accepted_task_count.load()
+		<< "   > tasks accepted with delay : " << m_DEBUG_record_delayed_task_count.load()
+		<< "   > tasks denied : " << m_DEBUG_record_denied_task_count.load()
+		<< "\n     > tasks completed : " << m_DEBUG_record_completed_task_count.load()
+		<< "   > currently unfinished tasks : " << m_unfinished_tasks.load()
+		<< "\n     > maximum occupancy recorded in task buffer : " << m_DEBUG_record_max_occupancy.load() << "\n" << std::endl;
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::DEBUG_write(const char* const filename)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	std::ofstream rec_write;
+	rec_write.open(filename, std::ios::app);
+	DEBUG_write_sub(rec_write);
+	rec_write.close();
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <typename msg_Ty>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::DEBUG_write(const char* const filename, const msg_Ty& msg)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	std::ofstream rec_write;
+	rec_write.open(filename, std::ios::app);
+	rec_write << "[ " << msg << " ]\n";
+	DEBUG_write_sub(rec_write);
+	rec_write.close();
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <typename msg_Ty1, typename msg_Ty2>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::DEBUG_write(const char* const filename, const msg_Ty1& msg1, const msg_Ty2& msg2)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	std::ofstream rec_write;
+	rec_write.open(filename, std::ios::app);
+	rec_write << "[ " << msg1 << " " << msg2 << " ]\n";
+	DEBUG_write_sub(rec_write);
+	rec_write.close();
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <typename msg_Ty1, typename msg_Ty2, typename msg_Ty3>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::DEBUG_write(const char* const filename, const msg_Ty1& msg1, const msg_Ty2& msg2, const msg_Ty3& msg3)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	std::ofstream rec_write;
+	rec_write.open(filename, std::ios::app);
+	rec_write << "[ " << msg1 << " " << msg2 << " " << msg3 << " ]\n";
+	DEBUG_write_sub(rec_write);
+	rec_write.close();
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <typename msg_Ty1, typename msg_Ty2, typename msg_Ty3, typename msg_Ty4>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::DEBUG_write(const char* const filename, const msg_Ty1& msg1, const msg_Ty2& msg2, const msg_Ty3& msg3, const msg_Ty4& msg4)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	std::ofstream rec_write;
+	rec_write.open(filename, std::ios::app);
+	rec_write << "[ " << msg1 << " " << msg2 << " " << msg3 << " " << msg4 << " ]\n";
+	DEBUG_write_sub(rec_write);
+	rec_write.close();
+}
+#endif // WELP_THREADS_INCLUDE_FSTREAM
+#endif // WELP_THREADS_DEBUG_MODE
+
+
+
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class function_Ty, class ... _Args>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::bind_task_sub(task_cell& new_task, std::nullptr_t, function_Ty&& task, _Args&& ... args)
+{
+	new_task.store(bound_task_type<function_Ty, _Args...>(std::forward<function_Ty>(task), std::forward<_Args>(args)...), static_cast<_Allocator&>(*this));
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class box_wait_Ty, class function_Ty, class ... _Args>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::bind_task_sub(task_cell& new_task, welp::basic_async_task_end<box_wait_Ty>* box_ptr, function_Ty&& task, _Args&& ... args)
+{
+	new_task.store(end_box_task<box_wait_Ty, bound_task_type<function_Ty, _Args...>>(
+		bound_task_type<function_Ty, _Args...>(std::forward<function_Ty>(task), std::forward<_Args>(args)...), *box_ptr), static_cast<_Allocator&>(*this));
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class return_Ty, class box_wait_Ty, class function_Ty, class ... _Args>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::bind_task_sub(task_cell& new_task, welp::async_task_result<return_Ty, box_wait_Ty>* box_ptr, function_Ty&& task, _Args&& ... args)
+{
+	new_task.store(result_box_task<return_Ty, box_wait_Ty, bound_task_type<function_Ty, _Args...>>(
+		bound_task_type<function_Ty, _Args...>(std::forward<function_Ty>(task), std::forward<_Args>(args)...), *box_ptr), static_cast<_Allocator&>(*this));
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class group_wait_Ty, class function_Ty, class ... _Args>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::bind_task_sub(task_cell& new_task, welp::basic_task_group<group_wait_Ty>* group_ptr, function_Ty&& task, _Args&& ... args)
+{
+	new_task.store(group_task<group_wait_Ty, bound_task_type<function_Ty, _Args...>>(
+		bound_task_type<function_Ty, _Args...>(std::forward<function_Ty>(task), std::forward<_Args>(args)...), *group_ptr), static_cast<_Allocator&>(*this));
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class target_ptr_Ty, class function_Ty, class ... _Args>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::make_task_sub(task_cell& new_task, target_ptr_Ty target_ptr, function_Ty&& task, _Args&& ... args) noexcept
+{
+	try
+	{
+		bind_task_sub(new_task, target_ptr, std::forward<function_Ty>(task), std::forward<_Args>(args)...);
+		return true;
+	}
+	catch (...)
+	{
+		return false;
+	}
+}
+
+// the task and its arguments may have been moved from when the cell can't be stored, so the failure is not retried,
+// the box or group already set up by the caller is released as denied and the exception is rethrown
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class target_ptr_Ty, class function_Ty, class ... _Args>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::force_make_task_sub(task_cell& new_task, target_ptr_Ty target_ptr, function_Ty&& task, _Args&& ... args)
+{
+	try
+	{
+		bind_task_sub(new_task, target_ptr, std::forward<function_Ty>(task), std::forward<_Args>(args)...);
+	}
+	catch (...)
+	{
+		deny_target_sub(target_ptr);
+		throw;
+	}
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class box_wait_Ty>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::deny_target_sub(welp::basic_async_task_end<box_wait_Ty>* box_ptr)
+{
+	box_ptr->m_task_denied.store(true, std::memory_order_release);
+	end_box_task<box_wait_Ty, denied_task<void>>(denied_task<void>(), *box_ptr)();
 }
 
-template <class _Allocator> template <class function_Ty, class ... _Args>
-bool welp::threads<_Allocator>::priority_async_task(const function_Ty& task, _Args&& ... args)
+// the box holds return_Ty() and its continuations are queued with it, like after a dropped task
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class return_Ty, class box_wait_Ty>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::deny_target_sub(welp::async_task_result<return_Ty, box_wait_Ty>* box_ptr)
 {
-	while (m_waiting_for_finish.load(std::memory_order_relaxed)) {}
-	std::unique_lock<std::mutex> lock(m_mutex);
+	box_ptr->m_task_denied.store(true, std::memory_order_release);
+	result_box_task<return_Ty, box_wait_Ty, denied_task<return_Ty>>(denied_task<return_Ty>(), *box_ptr)();
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class group_wait_Ty>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::deny_target_sub(welp::basic_task_group<group_wait_Ty>* group_ptr) noexcept
+{
+	group_ptr->count_down();
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+inline bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::push_task_sub(task_cell& new_task, std::size_t level)
+{
+	return push_task_sub(new_task, level, m_overflow_policy);
+}
+
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::push_task_sub(task_cell& new_task, std::size_t level, welp::threads_overflow overflow_policy)
+{
+	// no threads, hence no queues
+	if (m_task_ring.capacity() == 0)
+	{
+		return false;
+	}
 
-	if ((m_last_task_ptr + 1 != m_next_task_ptr) &&
-		((m_next_task_ptr != m_task_buffer_data_ptr) || (m_last_task_ptr + 1 != m_task_buffer_end_ptr)))
+	worker_deque* const local_deque_ptr = local_deque_sub();
+
+	// a thread of the pool submitting from inside a task must not wait for finish_all_tasks
+	if (!is_local_worker_sub())
 	{
-		m_waiting_tasks.fetch_add(1, std::memory_order_acquire);
-		m_unfinished_tasks.fetch_add(1, std::memory_order_acquire);
+		wait_Ty::wait_until(&m_waiting_for_finish, [this]() { return !m_waiting_for_finish.load(std::memory_order_acquire); });
+	}
 
-		try
+	m_waiting_tasks.fetch_add(1);
+	m_unfinished_tasks.fetch_add(1);
+
+#ifndef WELP_THREADS_NO_TELEMETRY
+	new_task.m_queued_time = m_telemetry_on.load(std::memory_order_relaxed) ? telemetry_time_sub() : 0;
+#endif // WELP_THREADS_NO_TELEMETRY
+
+	bool accepted;
+	if (level + 1 < m_number_of_levels)
+	{
+		accepted = (m_level_rings_ptr + level)->push(new_task);
+	}
+	else if (work_stealing && (local_deque_ptr != nullptr))
+	{
+		accepted = local_deque_ptr->push_bottom(new_task) || m_task_ring.push(new_task);
+	}
+	else if (m_node_rings_ptr != nullptr)
+	{
+		std::size_t node_number = local_node_sub();
+		accepted = ((node_number < m_number_of_nodes) && (m_node_rings_ptr + node_number)->push(new_task)) || m_task_ring.push(new_task);
+	}
+	else
+	{
+		accepted = m_task_ring.push(new_task);
+	}
+
+	if (!accepted)
+	{
+		if (overflow_policy == welp::threads_overflow::run_inline)
 		{
-			if (m_next_task_ptr != m_task_buffer_data_ptr)
-			{
-				*(m_next_task_ptr - 1) = [&]()
-				{
-					task(std::forward<_Args>(args)...);
-				};
-				m_next_task_ptr--;
-			}
-			else
-			{
-				*(m_task_buffer_end_ptr - 1) = [&]()
-				{
-					task(std::forward<_Args>(args)...);
-				};
-				m_next_task_ptr = m_task_buffer_end_ptr - 1;
-			}
+			m_waiting_tasks.fetch_sub(1, std::memory_order_release);
+			run_task_sub(new_task);
+			return true;
 		}
-		catch (...)
+		if ((overflow_policy != welp::threads_overflow::spill) || !spill_task_sub(new_task, level))
 		{
 			m_waiting_tasks.fetch_sub(1, std::memory_order_release);
 			m_unfinished_tasks.fetch_sub(1, std::memory_order_release);
-
-#ifdef WELP_THREADS_DEBUG_MODE
-			if (m_DEBUG_record_on)
-			{
-				m_DEBUG_record_denied_task_count.fetch_add(1);
-			}
-#endif // WELP_THREADS_DEBUG_MODE
-
 			return false;
 		}
+	}
 
-		m_condition_var.notify_one();
+	wake_threads_sub(1);
+	if (m_max_threads != 0)
+	{
+		grow_sub();
+	}
 
 #ifdef WELP_THREADS_DEBUG_MODE
-		if (m_DEBUG_record_on)
-		{
-			m_DEBUG_record_accepted_task_count++;
-			std::size_t temp = m_waiting_tasks.load();
-			if (temp > m_DEBUG_record_max_occupancy.load())
-			{
-				m_DEBUG_record_max_occupancy.store(temp);
-			}
-		}
-#endif // WELP_THREADS_DEBUG_MODE
-
-		return true;
-	}
-	else
+	if (m_DEBUG_record_on)
 	{
-#ifdef WELP_THREADS_DEBUG_MODE
-		if (m_DEBUG_record_on)
+		m_DEBUG_record_accepted_task_count.fetch_add(1);
+		std::size_t temp = m_waiting_tasks.load();
+		if (temp > m_DEBUG_record_max_occupancy.load())
 		{
-			m_DEBUG_record_denied_task_count.fetch_add(1);
+			m_DEBUG_record_max_occupancy.store(temp);
 		}
+	}
 #endif // WELP_THREADS_DEBUG_MODE
 
-		return false;
-	}
+	return true;
 }
 
-template <class _Allocator> template <class function_Ty, class ... _Args>
-void welp::threads<_Allocator>::force_priority_async_task(const function_Ty& task, _Args&& ... args)
+// levels past the lowest one are clamped to the lowest one
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+inline std::size_t welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::level_sub(welp::threads_priority priority) const noexcept
 {
-#ifdef WELP_THREADS_DEBUG_MODE
-	if (!force_priority_async_task_sub(task, std::forward<_Args>(args)...))
+	return (priority.level() < m_number_of_levels) ? priority.level() : m_number_of_levels - 1;
+}
+
+// a few chunks per thread so that the threads even out uneven chunks, with at least WELP_THREADS_REDUCE_GRAIN elements per chunk
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+inline std::size_t welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::reduce_chunks_sub(std::size_t count) const noexcept
+{
+	std::size_t number_of_chunks = 4 * m_number_of_threads.load(std::memory_order_relaxed);
+	std::size_t max_number_of_chunks = count / WELP_THREADS_REDUCE_GRAIN;
+	if (number_of_chunks > max_number_of_chunks)
 	{
-		m_DEBUG_record_delayed_task_count.fetch_add(1);
+		number_of_chunks = max_number_of_chunks;
 	}
-	else { return; }
-#endif // WELP_THREADS_DEBUG_MODE
-	while (!force_priority_async_task_sub(task, std::forward<_Args>(args)...)) {}
+	return (number_of_chunks != 0) ? number_of_chunks : 1;
 }
 
-
-template <class _Allocator> template <class function_Ty, class ... _Args>
-bool welp::threads<_Allocator>::async_task(welp::async_task_end& box, const function_Ty& task, _Args&& ... args)
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+inline std::size_t welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::chunk_begin_sub(std::size_t count, std::size_t number_of_chunks, std::size_t chunk) noexcept
 {
-	while (m_waiting_for_finish.load(std::memory_order_relaxed)) {}
-	std::unique_lock<std::mutex> lock(m_mutex);
+	std::size_t remainder = count % number_of_chunks;
+	return (count / number_of_chunks) * chunk + ((chunk < remainder) ? chunk : remainder);
+}
 
-	if ((m_last_task_ptr + 1 != m_next_task_ptr) &&
-		((m_next_task_ptr != m_task_buffer_data_ptr) || (m_last_task_ptr + 1 != m_task_buffer_end_ptr)) &&
-		!box.m_task_running.load(std::memory_order_acquire))
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::force_push_task_sub(task_cell& new_task, std::size_t level)
+{
+	// only the threads of the pool free spots, so a thread of the pool runs the task itself instead of waiting
+	if (is_local_worker_sub())
 	{
-		m_waiting_tasks.fetch_add(1, std::memory_order_acquire);
-		m_unfinished_tasks.fetch_add(1, std::memory_order_acquire);
-		box.m_task_running.store(true, std::memory_order_acquire);
-		box.m_task_denied.store(false, std::memory_order_acquire);
-
-		try
+		if (!push_task_sub(new_task, level))
 		{
-			*m_last_task_ptr = [&]()
-			{
-				task(std::forward<_Args>(args)...);
-				box.m_task_running.store(false, std::memory_order_release);
-			};
+			push_task_sub(new_task, level, welp::threads_overflow::run_inline);
 		}
-		catch (...)
-		{
-			m_waiting_tasks.fetch_sub(1, std::memory_order_release);
-			m_unfinished_tasks.fetch_sub(1, std::memory_order_release);
-			box.m_task_running.store(false, std::memory_order_release);
-			box.m_task_denied.store(true, std::memory_order_release);
-
-#ifdef WELP_THREADS_DEBUG_MODE
-			if (m_DEBUG_record_on)
-			{
-				m_DEBUG_record_denied_task_count.fetch_add(1);
-			}
-#endif // WELP_THREADS_DEBUG_MODE
+		return;
+	}
 
-			return false;
+	while (true)
+	{
+		std::size_t waiting_tasks = m_waiting_tasks.load();
+		if (push_task_sub(new_task, level))
+		{
+			return;
 		}
+		wait_Ty::wait_until(&m_waiting_tasks, [&]() { return m_waiting_tasks.load() != waiting_tasks; });
+	}
+}
 
-		m_last_task_ptr++;
-		if (m_last_task_ptr == m_task_buffer_end_ptr)
+// sleeps until a task is taken from the queue or until the deadline, then tries again
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::push_task_until_sub(task_cell& new_task, std::size_t level, std::chrono::steady_clock::time_point deadline)
+{
+	while (true)
+	{
+		std::size_t waiting_tasks = m_waiting_tasks.load();
+		if (push_task_sub(new_task, level))
 		{
-			m_last_task_ptr = m_task_buffer_data_ptr;
+			return true;
 		}
 
-		m_condition_var.notify_one();
-
-#ifdef WELP_THREADS_DEBUG_MODE
-		if (m_DEBUG_record_on)
+		bool space_freed;
 		{
-			m_DEBUG_record_accepted_task_count++;
-			std::size_t temp = m_waiting_tasks.load();
-			if (temp > m_DEBUG_record_max_occupancy.load())
-			{
-				m_DEBUG_record_max_occupancy.store(temp);
-			}
+			std::unique_lock<std::mutex> lock(m_space_mutex);
+			m_space_waiters.fetch_add(1);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			space_freed = m_space_condition_var.wait_until(lock, deadline, [&]() { return m_waiting_tasks.load() != waiting_tasks; });
+			m_space_waiters.fetch_sub(1);
 		}
-#endif // WELP_THREADS_DEBUG_MODE
+		if (!space_freed)
+		{
+			return push_task_sub(new_task, level);
+		}
+	}
+}
 
-		return true;
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::spill_task_sub(task_cell& new_task, std::size_t level) noexcept
+{
+	spill_node* node_ptr = static_cast<spill_node*>(static_cast<void*>(this->allocate(sizeof(spill_node))));
+	if (node_ptr == nullptr)
+	{
+		return false;
+	}
+	new (node_ptr) spill_node();
+	new_task.relocate_to(node_ptr->m_task);
+	node_ptr->m_level = level;
+
+	std::lock_guard<std::mutex> lock(m_spill_mutex);
+	if (m_spill_tail_ptr != nullptr)
+	{
+		m_spill_tail_ptr->m_next_ptr = node_ptr;
 	}
 	else
 	{
-		box.m_task_denied.store(true, std::memory_order_release);
+		m_spill_head_ptr = node_ptr;
+	}
+	m_spill_tail_ptr = node_ptr;
+	m_spilled_tasks.fetch_add(1, std::memory_order_release);
+	return true;
+}
 
-#ifdef WELP_THREADS_DEBUG_MODE
-		if (m_DEBUG_record_on)
+// taken by a thread that finds every queue empty
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::pop_spilled_task_sub(task_cell& current_task) noexcept
+{
+	spill_node* node_ptr;
+	{
+		std::lock_guard<std::mutex> lock(m_spill_mutex);
+		node_ptr = m_spill_head_ptr;
+		if (node_ptr == nullptr)
 		{
-			m_DEBUG_record_denied_task_count.fetch_add(1);
+			return false;
 		}
-#endif // WELP_THREADS_DEBUG_MODE
+		m_spill_head_ptr = node_ptr->m_next_ptr;
+		if (m_spill_head_ptr == nullptr)
+		{
+			m_spill_tail_ptr = nullptr;
+		}
+		m_spilled_tasks.fetch_sub(1, std::memory_order_release);
+	}
+	node_ptr->m_task.relocate_to(current_task);
+	m_waiting_tasks.fetch_sub(1, std::memory_order_release);
+	node_ptr->~spill_node();
+	this->deallocate(static_cast<char*>(static_cast<void*>(node_ptr)), sizeof(spill_node));
+	return true;
+}
 
-		return false;
+// moves the oldest spilled task back to its queue if there is a free spot, skipped if another thread is at it
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::refill_sub() noexcept
+{
+	spill_node* node_ptr;
+	{
+		std::unique_lock<std::mutex> lock(m_spill_mutex, std::try_to_lock);
+		if (!lock.owns_lock() || (m_spill_head_ptr == nullptr))
+		{
+			return;
+		}
+		node_ptr = m_spill_head_ptr;
+		task_ring& ring = (node_ptr->m_level + 1 < m_number_of_levels) ? *(m_level_rings_ptr + node_ptr->m_level) : m_task_ring;
+		if (!ring.push(node_ptr->m_task))
+		{
+			return;
+		}
+		m_spill_head_ptr = node_ptr->m_next_ptr;
+		if (m_spill_head_ptr == nullptr)
+		{
+			m_spill_tail_ptr = nullptr;
+		}
+		m_spilled_tasks.fetch_sub(1, std::memory_order_release);
 	}
+	node_ptr->~spill_node();
+	this->deallocate(static_cast<char*>(static_cast<void*>(node_ptr)), sizeof(spill_node));
 }
 
-template <class _Allocator> template <class function_Ty, class ... _Args>
-void welp::threads<_Allocator>::force_async_task(welp::async_task_end& box, const function_Ty& task, _Args&& ... args)
+// the spilled tasks still waiting are dropped like the tasks still in the queues
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::delete_spilled_tasks_sub() noexcept
 {
-#ifdef WELP_THREADS_DEBUG_MODE
-	if (!force_async_task_sub(box, task, std::forward<_Args>(args)...))
+	std::lock_guard<std::mutex> lock(m_spill_mutex);
+	while (m_spill_head_ptr != nullptr)
 	{
-		m_DEBUG_record_delayed_task_count.fetch_add(1, std::memory_order_relaxed);
+		spill_node* node_ptr = m_spill_head_ptr;
+		m_spill_head_ptr = node_ptr->m_next_ptr;
+		node_ptr->~spill_node();
+		this->deallocate(static_cast<char*>(static_cast<void*>(node_ptr)), sizeof(spill_node));
 	}
-	else { return; }
-#endif // WELP_THREADS_DEBUG_MODE
-	while (!force_async_task_sub(box, task, std::forward<_Args>(args)...)) {}
+	m_spill_tail_ptr = nullptr;
+	m_spilled_tasks.store(0);
 }
 
-template <class _Allocator> template <class function_Ty, class ... _Args>
-bool welp::threads<_Allocator>::priority_async_task(welp::async_task_end& box, const function_Ty& task, _Args&& ... args)
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class make_Ty>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::push_block_sub(std::size_t count, make_Ty&& make_task)
 {
-	while (m_waiting_for_finish.load(std::memory_order_relaxed)) {}
-	std::unique_lock<std::mutex> lock(m_mutex);
+	// no threads, parallel_for runs the chunks in the calling thread and async_batch is denied
+	if (m_task_ring.capacity() == 0)
+	{
+		return false;
+	}
 
-	if ((m_last_task_ptr + 1 != m_next_task_ptr) &&
-		((m_next_task_ptr != m_task_buffer_data_ptr) || (m_last_task_ptr + 1 != m_task_buffer_end_ptr)) &&
-		!box.m_task_running.load(std::memory_order_acquire))
+	if (!is_local_worker_sub())
 	{
-		m_waiting_tasks.fetch_add(1, std::memory_order_acquire);
-		m_unfinished_tasks.fetch_add(1, std::memory_order_acquire);
-		box.m_task_running.store(true, std::memory_order_acquire);
-		box.m_task_denied.store(false, std::memory_order_acquire);
+		wait_Ty::wait_until(&m_waiting_for_finish, [this]() { return !m_waiting_for_finish.load(std::memory_order_acquire); });
+	}
 
-		try
-		{
-			if (m_next_task_ptr != m_task_buffer_data_ptr)
-			{
-				*(m_next_task_ptr - 1) = [&]()
-				{
-					task(std::forward<_Args>(args)...);
-					box.m_task_running.store(false);
-				};
-				m_next_task_ptr--;
-			}
-			else
-			{
-				*(m_task_buffer_end_ptr - 1) = [&]()
-				{
-					task(std::forward<_Args>(args)...);
-					box.m_task_running.store(false);
-				};
-				m_next_task_ptr = m_task_buffer_end_ptr - 1;
-			}
-		}
-		catch (...)
-		{
-			m_waiting_tasks.fetch_sub(1, std::memory_order_release);
-			m_unfinished_tasks.fetch_sub(1, std::memory_order_release);
-			box.m_task_running.store(false, std::memory_order_release);
-			box.m_task_denied.store(true, std::memory_order_release);
+	m_waiting_tasks.fetch_add(count);
+	m_unfinished_tasks.fetch_add(count);
 
-#ifdef WELP_THREADS_DEBUG_MODE
-			if (m_DEBUG_record_on)
-			{
-				m_DEBUG_record_denied_task_count.fetch_add(1);
-			}
-#endif // WELP_THREADS_DEBUG_MODE
+	std::size_t position;
+	if (!m_task_ring.reserve(count, position))
+	{
+		m_waiting_tasks.fetch_sub(count, std::memory_order_release);
+		m_unfinished_tasks.fetch_sub(count, std::memory_order_release);
+		return false;
+	}
 
-			return false;
-		}
+#ifndef WELP_THREADS_NO_TELEMETRY
+	std::int64_t queued_time = m_telemetry_on.load(std::memory_order_relaxed) ? telemetry_time_sub() : 0;
+#endif // WELP_THREADS_NO_TELEMETRY
+	for (std::size_t k = 0; k < count; k++)
+	{
+		task_cell& new_task = m_task_ring.reserved_cell(position + k);
+		make_task(new_task);
+#ifndef WELP_THREADS_NO_TELEMETRY
+		new_task.m_queued_time = queued_time;
+#endif // WELP_THREADS_NO_TELEMETRY
+		m_task_ring.publish(position + k);
+	}
 
-		m_condition_var.notify_one();
+	wake_threads_sub(count);
+	if (m_max_threads != 0)
+	{
+		grow_sub();
+	}
 
 #ifdef WELP_THREADS_DEBUG_MODE
-		if (m_DEBUG_record_on)
+	if (m_DEBUG_record_on)
+	{
+		m_DEBUG_record_accepted_task_count.fetch_add(static_cast<WELP_THREADS_RECORD_INT>(count));
+		std::size_t temp = m_waiting_tasks.load();
+		if (temp > m_DEBUG_record_max_occupancy.load())
 		{
-			m_DEBUG_record_accepted_task_count++;
-			std::size_t temp = m_waiting_tasks.load();
-			if (temp > m_DEBUG_record_max_occupancy.load())
-			{
-				m_DEBUG_record_max_occupancy.store(temp);
-			}
+			m_DEBUG_record_max_occupancy.store(temp);
 		}
+	}
 #endif // WELP_THREADS_DEBUG_MODE
 
-		return true;
-	}
-	else
-	{
-		box.m_task_denied.store(true, std::memory_order_release);
+	return true;
+}
 
-#ifdef WELP_THREADS_DEBUG_MODE
-		if (m_DEBUG_record_on)
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+inline void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::run_task_sub(task_cell& current_task)
+{
+	// a force_ function may be waiting for a free spot
+	wait_Ty::notify_all(&m_waiting_tasks);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (m_space_waiters.load(std::memory_order_relaxed) != 0)
+	{
 		{
-			m_DEBUG_record_denied_task_count.fetch_add(1);
+			std::lock_guard<std::mutex> lock(m_space_mutex);
 		}
-#endif // WELP_THREADS_DEBUG_MODE
+		m_space_condition_var.notify_all();
+	}
+	if (m_spilled_tasks.load(std::memory_order_relaxed) != 0)
+	{
+		refill_sub();
+	}
 
-		return false;
+	current_task.run();
+	if (m_unfinished_tasks.fetch_sub(1, std::memory_order_release) == 1)
+	{
+		wait_Ty::notify_all(&m_unfinished_tasks);
 	}
-}
 
-template <class _Allocator> template <class function_Ty, class ... _Args>
-void welp::threads<_Allocator>::force_priority_async_task(welp::async_task_end& box, const function_Ty& task, _Args&& ... args)
-{
 #ifdef WELP_THREADS_DEBUG_MODE
-	if (!force_priority_async_task_sub(box, task, std::forward<_Args>(args)...))
+	if (m_DEBUG_record_on)
 	{
-		m_DEBUG_record_delayed_task_count.fetch_add(1, std::memory_order_relaxed);
+		m_DEBUG_record_completed_task_count.fetch_add(1);
 	}
-	else { return; }
 #endif // WELP_THREADS_DEBUG_MODE
-	while (!force_priority_async_task_sub(box, task, std::forward<_Args>(args)...)) {}
 }
 
-
-template <class _Allocator> template <class return_Ty, class function_Ty, class ... _Args>
-bool welp::threads<_Allocator>::async_task(welp::async_task_result<return_Ty>& box, const function_Ty& task, _Args&& ... args)
+// the mutex is only taken if a thread might be parked
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+inline void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::wake_threads_sub(std::size_t count)
 {
-	while (m_waiting_for_finish.load(std::memory_order_relaxed)) {}
-	std::unique_lock<std::mutex> lock(m_mutex);
-
-	if ((m_last_task_ptr + 1 != m_next_task_ptr) &&
-		((m_next_task_ptr != m_task_buffer_data_ptr) || (m_last_task_ptr + 1 != m_task_buffer_end_ptr)) &&
-		!box.m_task_running.load())
+	std::size_t sleeping_threads = m_sleeping_threads.load();
+	if (sleeping_threads != 0)
 	{
-		m_waiting_tasks.fetch_add(1, std::memory_order_acquire);
-		m_unfinished_tasks.fetch_add(1, std::memory_order_acquire);
-		box.m_task_running.store(true, std::memory_order_acquire);
-		box.m_task_denied.store(false, std::memory_order_acquire);
-
-		try
 		{
-			*m_last_task_ptr = [&]()
-			{
-				box.m_stored_value = task(std::forward<_Args>(args)...);
-				box.m_task_running.store(false, std::memory_order_release);
-			};
+			std::lock_guard<std::mutex> lock(m_mutex);
 		}
-		catch (...)
+		if (count >= sleeping_threads)
 		{
-			m_waiting_tasks.fetch_sub(1, std::memory_order_release);
-			m_unfinished_tasks.fetch_sub(1, std::memory_order_release);
-			box.m_task_running.store(false, std::memory_order_release);
-			box.m_task_denied.store(true, std::memory_order_release);
-
-#ifdef WELP_THREADS_DEBUG_MODE
-			if (m_DEBUG_record_on)
+			m_condition_var.notify_all();
+		}
+		else
+		{
+			for (std::size_t k = 0; k < count; k++)
 			{
-				m_DEBUG_record_denied_task_count.fetch_add(1);
+				m_condition_var.notify_one();
 			}
-#endif // WELP_THREADS_DEBUG_MODE
-
-			return false;
 		}
+	}
+}
 
-
-		m_last_task_ptr++;
-		if (m_last_task_ptr == m_task_buffer_end_ptr)
+// strict policy : levels from 0 to the lowest, weighted policy : the level picked by the count of pops first,
+// then the levels from 0 to the lowest so that a thread never idles while a task is waiting
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+inline bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::pop_task_sub(task_cell& current_task, std::size_t thread_number)
+{
+	std::size_t first_level = m_number_of_levels;
+	if (m_total_weight != 0)
+	{
+		std::size_t weight_slot = (local_identity_sub().pop_count++) % m_total_weight;
+		first_level = 0;
+		while (weight_slot >= m_level_weights[first_level])
+		{
+			weight_slot -= m_level_weights[first_level];
+			first_level++;
+		}
+		if (pop_level_sub(current_task, thread_number, first_level))
 		{
-			m_last_task_ptr = m_task_buffer_data_ptr;
+			return true;
 		}
+	}
 
-		m_condition_var.notify_one();
+	for (std::size_t level = 0; level < m_number_of_levels; level++)
+	{
+		if ((level != first_level) && pop_level_sub(current_task, thread_number, level))
+		{
+			return true;
+		}
+	}
+	return (m_spilled_tasks.load(std::memory_order_relaxed) != 0) && pop_spilled_task_sub(current_task);
+}
 
-#ifdef WELP_THREADS_DEBUG_MODE
-		if (m_DEBUG_record_on)
+// lowest level : own deque in work stealing mode, then the queue of the node of the thread if any,
+// then the shared queue, then the queues of the other nodes, then the deques of the other threads
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+inline bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::pop_level_sub(task_cell& current_task, std::size_t thread_number, std::size_t level)
+{
+	if (level + 1 < m_number_of_levels)
+	{
+		if ((m_level_rings_ptr + level)->pop(current_task))
 		{
-			m_DEBUG_record_accepted_task_count++;
-			std::size_t temp = m_waiting_tasks.load();
-			if (temp > m_DEBUG_record_max_occupancy.load())
-			{
-				m_DEBUG_record_max_occupancy.store(temp);
-			}
+			m_waiting_tasks.fetch_sub(1, std::memory_order_release);
+			return true;
 		}
-#endif // WELP_THREADS_DEBUG_MODE
+		return false;
+	}
+
+	if (work_stealing && (m_worker_deques_ptr + thread_number)->pop_bottom(current_task))
+	{
+		m_waiting_tasks.fetch_sub(1, std::memory_order_release);
 		return true;
 	}
-	else
+
+	std::size_t node_number = local_identity_sub().node_number;
+	if ((m_node_rings_ptr != nullptr) && (m_node_rings_ptr + node_number)->pop(current_task))
+	{
+		m_waiting_tasks.fetch_sub(1, std::memory_order_release);
+		return true;
+	}
+
+	if (m_task_ring.pop(current_task))
 	{
-		box.m_task_denied.store(true, std::memory_order_release);
+		m_waiting_tasks.fetch_sub(1, std::memory_order_release);
+		return true;
+	}
 
-#ifdef WELP_THREADS_DEBUG_MODE
-		if (m_DEBUG_record_on)
+	for (std::size_t n = 1; n < m_number_of_nodes; n++)
+	{
+		node_number = (node_number + 1 == m_number_of_nodes) ? 0 : node_number + 1;
+		if ((m_node_rings_ptr + node_number)->pop(current_task))
 		{
-			m_DEBUG_record_denied_task_count.fetch_add(1);
+			m_waiting_tasks.fetch_sub(1, std::memory_order_release);
+			count_steal_sub();
+			return true;
+		}
+	}
+
+	if (work_stealing)
+	{
+		std::size_t victim_number = thread_number;
+		for (std::size_t k = m_thread_capacity - 1; k > 0; k--)
+		{
+			victim_number++;
+			if (victim_number == m_thread_capacity)
+			{
+				victim_number = 0;
+			}
+			if ((m_worker_deques_ptr + victim_number)->steal_top(current_task))
+			{
+				m_waiting_tasks.fetch_sub(1, std::memory_order_release);
+				count_steal_sub();
+				return true;
+			}
 		}
-#endif // WELP_THREADS_DEBUG_MODE
-
-		return false;
 	}
+
+	return false;
 }
 
-template <class _Allocator> template <class return_Ty, class function_Ty, class ... _Args>
-void welp::threads<_Allocator>::force_async_task(welp::async_task_result<return_Ty>& box, const function_Ty& task, _Args&& ... args)
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::worker_loop_sub(std::size_t thread_number)
 {
-#ifdef WELP_THREADS_DEBUG_MODE
-	if (!force_async_task_sub(box, task, std::forward<_Args>(args)...))
+	local_identity_sub().pool_ptr = this;
+	local_identity_sub().thread_number = thread_number;
+	local_identity_sub().node_number = 0;
+
+	// pinned before touching any memory so that the stack and the allocations of the thread stay on its node
+	if (m_affinity_ptr != nullptr)
 	{
-		m_DEBUG_record_delayed_task_count.fetch_add(1, std::memory_order_relaxed);
+		pin_thread_sub(thread_number);
+		local_identity_sub().node_number = (m_node_rings_ptr != nullptr) ?
+			m_affinity_ptr->m_slot_nodes[thread_number % m_affinity_ptr->m_number_of_slots] : 0;
 	}
-	else { return; }
-#endif // WELP_THREADS_DEBUG_MODE
-	while (!force_async_task_sub(box, task, std::forward<_Args>(args)...)) {}
-}
 
-template <class _Allocator> template <class return_Ty, class function_Ty, class ... _Args>
-bool welp::threads<_Allocator>::priority_async_task(welp::async_task_result<return_Ty>& box, const function_Ty& task, _Args&& ... args)
-{
-	while (m_waiting_for_finish.load(std::memory_order_relaxed)) {}
-	std::unique_lock<std::mutex> lock(m_mutex);
+	task_cell current_task;
 
-	if ((m_last_task_ptr + 1 != m_next_task_ptr) &&
-		((m_next_task_ptr != m_task_buffer_data_ptr) || (m_last_task_ptr + 1 != m_task_buffer_end_ptr)) &&
-		!box.m_task_running.load())
+	while (true)
 	{
-		m_waiting_tasks.fetch_add(1, std::memory_order_acquire);
-		m_unfinished_tasks.fetch_add(1, std::memory_order_acquire);
-		box.m_task_running.store(true, std::memory_order_acquire);
-		box.m_task_denied.store(false, std::memory_order_acquire);
+		if ((m_threads_to_retire.load(std::memory_order_relaxed) != 0) && retire_thread_sub(thread_number, false))
+		{
+			break;
+		}
+		if (m_timed_task_count.load(std::memory_order_relaxed) != 0)
+		{
+			dispatch_timed_tasks_sub();
+		}
 
-		try
+		if (!pop_task_sub(current_task, thread_number))
 		{
-			if (m_next_task_ptr != m_task_buffer_data_ptr)
+			for (std::size_t n = 64; (n > 0) && (m_waiting_tasks.load(std::memory_order_relaxed) == 0); n--)
 			{
-				*(m_next_task_ptr - 1) = [&]()
-				{
-					box.m_stored_value = task(std::forward<_Args>(args)...);
-					box.m_task_running.store(false);
-				};
-				m_next_task_ptr--;
+				std::this_thread::yield();
+			}
+			if (m_waiting_tasks.load(std::memory_order_relaxed) != 0)
+			{
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_sleeping_threads.fetch_add(1);
+			std::size_t timer_epoch = m_timer_epoch.load();
+			auto wake_ready = [this, timer_epoch]()
+			{
+				return (m_waiting_tasks.load() != 0) || m_stop_threads || (m_threads_to_retire.load() != 0) || (m_timer_epoch.load() != timer_epoch);
+			};
+
+			// sleeps until the next deadline of a timed task or the end of the idle time if any
+			bool elastic = (m_max_threads != 0) && (m_idle_time.count() > 0);
+			std::int64_t next_deadline = m_next_deadline.load();
+			bool idle = false;
+			if (!elastic && (next_deadline == INT64_MAX))
+			{
+				m_condition_var.wait(lock, wake_ready);
 			}
 			else
 			{
-				*(m_task_buffer_end_ptr - 1) = [&]()
+				std::chrono::steady_clock::time_point idle_time_point = std::chrono::steady_clock::now()
+					+ std::chrono::duration_cast<std::chrono::steady_clock::duration>(elastic ? m_idle_time : std::chrono::hours(24));
+				std::chrono::steady_clock::time_point wake_time_point = idle_time_point;
+				if (next_deadline != INT64_MAX)
 				{
-					box.m_stored_value = task(std::forward<_Args>(args)...);
-					box.m_task_running.store(false);
-				};
-				m_next_task_ptr = m_task_buffer_end_ptr - 1;
+					std::chrono::steady_clock::time_point deadline_time_point{ std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+						std::chrono::nanoseconds(next_deadline)) };
+					wake_time_point = (deadline_time_point < wake_time_point) ? deadline_time_point : wake_time_point;
+				}
+				idle = !m_condition_var.wait_until(lock, wake_time_point, wake_ready) && elastic
+					&& (std::chrono::steady_clock::now() >= idle_time_point);
 			}
-		}
-		catch (...)
-		{
-			m_waiting_tasks.fetch_sub(1, std::memory_order_release);
-			m_unfinished_tasks.fetch_sub(1, std::memory_order_release);
-			box.m_task_running.store(false, std::memory_order_release);
-			box.m_task_denied.store(true, std::memory_order_release);
+			m_sleeping_threads.fetch_sub(1);
 
-#ifdef WELP_THREADS_DEBUG_MODE
-			if (m_DEBUG_record_on)
+			if (m_stop_threads && (m_waiting_tasks.load() == 0))
 			{
-				m_DEBUG_record_denied_task_count.fetch_add(1);
+				break;
 			}
-#endif // WELP_THREADS_DEBUG_MODE
-
-			return false;
+			if (idle && retire_thread_sub(thread_number, true))
+			{
+				break;
+			}
+			continue;
 		}
 
-		m_condition_var.notify_one();
+		run_worker_task_sub(current_task, thread_number);
+	}
 
-#ifdef WELP_THREADS_DEBUG_MODE
-		if (m_DEBUG_record_on)
+	local_identity_sub().pool_ptr = nullptr;
+	(m_worker_slots_ptr + thread_number)->m_running.store(false, std::memory_order_release);
+}
+
+// pending retirements are cancelled before starting new threads
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+std::size_t welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::add_threads_sub(std::size_t number_of_new_threads, std::size_t max_number_of_threads)
+{
+	if ((m_worker_slots_ptr == nullptr) || reinterpret_cast<std::atomic<bool>&>(m_stop_threads).load())
+	{
+		return 0;
+	}
+
+	std::size_t added_threads = 0;
+	std::size_t threads_to_retire = m_threads_to_retire.load();
+	while ((added_threads < number_of_new_threads) && (threads_to_retire != 0))
+	{
+		if (m_threads_to_retire.compare_exchange_weak(threads_to_retire, threads_to_retire - 1))
 		{
-			m_DEBUG_record_accepted_task_count++;
-			std::size_t temp = m_waiting_tasks.load();
-			if (temp > m_DEBUG_record_max_occupancy.load())
-			{
-				m_DEBUG_record_max_occupancy.store(temp);
-			}
+			threads_to_retire--;
+			added_threads++;
 		}
-#endif // WELP_THREADS_DEBUG_MODE
-		return true;
 	}
-	else
+
+	for (std::size_t k = 0; (k < m_thread_capacity) && (added_threads < number_of_new_threads)
+		&& (m_number_of_threads.load() < max_number_of_threads); k++)
 	{
-		box.m_task_denied.store(true, std::memory_order_release);
+		worker_slot* slot_ptr = m_worker_slots_ptr + k;
+		if (slot_ptr->m_running.load(std::memory_order_acquire))
+		{
+			continue;
+		}
+		if (slot_ptr->m_thread.joinable())
+		{
+			slot_ptr->m_thread.join();
+		}
+		if (work_stealing && ((m_worker_deques_ptr + k)->m_cells_ptr == nullptr) && !new_deque_sub(k))
+		{
+			break;
+		}
 
-#ifdef WELP_THREADS_DEBUG_MODE
-		if (m_DEBUG_record_on)
+		slot_ptr->m_running.store(true, std::memory_order_relaxed);
+		m_number_of_threads.fetch_add(1);
+		try
 		{
-			m_DEBUG_record_denied_task_count.fetch_add(1);
+			slot_ptr->m_thread = std::thread([this, k]() { worker_loop_sub(k); });
 		}
-#endif // WELP_THREADS_DEBUG_MODE
-		return false;
+		catch (...)
+		{
+			slot_ptr->m_running.store(false, std::memory_order_relaxed);
+			m_number_of_threads.fetch_sub(1);
+			break;
+		}
+		added_threads++;
 	}
+
+	return added_threads;
 }
 
-template <class _Allocator> template <class return_Ty, class function_Ty, class ... _Args>
-void welp::threads<_Allocator>::force_priority_async_task(welp::async_task_result<return_Ty>& box, const function_Ty& task, _Args&& ... args)
+// a thread only leaves with an empty deque, never below one thread and never below the minimum when idle
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::retire_thread_sub(std::size_t thread_number, bool idle) noexcept
 {
+	if (work_stealing && !(m_worker_deques_ptr + thread_number)->empty())
+	{
+		return false;
+	}
 
-#ifdef WELP_THREADS_DEBUG_MODE
-	if (!force_priority_async_task_sub(box, task, std::forward<_Args>(args)...))
+	if (!idle)
 	{
-		m_DEBUG_record_delayed_task_count.fetch_add(1, std::memory_order_relaxed);
+		std::size_t threads_to_retire = m_threads_to_retire.load();
+		do
+		{
+			if (threads_to_retire == 0)
+			{
+				return false;
+			}
+		} while (!m_threads_to_retire.compare_exchange_weak(threads_to_retire, threads_to_retire - 1));
 	}
-	else { return; }
-#endif // WELP_THREADS_DEBUG_MODE
-	while (!force_priority_async_task_sub(box, task, std::forward<_Args>(args)...)) {}
-}
 
+	std::size_t min_number_of_threads = (idle && (m_min_threads > 1)) ? m_min_threads : 1;
+	std::size_t number_of_threads = m_number_of_threads.load();
+	do
+	{
+		if (number_of_threads <= min_number_of_threads)
+		{
+			return false;
+		}
+	} while (!m_number_of_threads.compare_exchange_weak(number_of_threads, number_of_threads - 1));
 
-template <class _Allocator>
-void welp::threads<_Allocator>::finish_all_tasks() noexcept
-{
-	m_waiting_for_finish.store(true, std::memory_order_release);
-	while (m_unfinished_tasks.load(std::memory_order_relaxed) != 0) {}
-	m_waiting_for_finish.store(false, std::memory_order_release);
+	return true;
 }
 
-template <class _Allocator>
-inline std::size_t welp::threads<_Allocator>::waiting_task_count() const noexcept
+// only called with tasks waiting, the mutex is never waited for by a thread queuing tasks
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+inline void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::grow_sub()
 {
-	return m_waiting_tasks.load();
+	std::size_t number_of_threads = m_number_of_threads.load(std::memory_order_relaxed);
+	if ((number_of_threads < m_max_threads) && (m_sleeping_threads.load(std::memory_order_relaxed) == 0)
+		&& (m_waiting_tasks.load(std::memory_order_relaxed) > number_of_threads))
+	{
+		std::unique_lock<std::mutex> resize_lock(m_resize_mutex, std::try_to_lock);
+		if (resize_lock.owns_lock())
+		{
+			add_threads_sub(1, m_max_threads);
+		}
+	}
 }
 
-template <class _Allocator>
-inline std::size_t welp::threads<_Allocator>::unfinished_task_count() const noexcept
+// the deque of a slot is allocated when a thread first starts in the slot and kept until delete_threads
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::new_deque_sub(std::size_t thread_number)
 {
-	return m_unfinished_tasks.load();
+	std::size_t deque_capacity = m_task_ring.capacity();
+	worker_deque* deque_ptr = m_worker_deques_ptr + thread_number;
+	typename worker_deque::deque_cell* cells_ptr = static_cast<typename worker_deque::deque_cell*>(static_cast<void*>(
+		this->allocate(deque_capacity * sizeof(typename worker_deque::deque_cell))));
+	if (cells_ptr == nullptr)
+	{
+		return false;
+	}
+	for (std::size_t n = 0; n < deque_capacity; n++)
+	{
+		new (cells_ptr + n) typename worker_deque::deque_cell();
+		(cells_ptr + n)->m_sequence.store(n, std::memory_order_relaxed);
+	}
+	deque_ptr->m_capacity = deque_capacity;
+	deque_ptr->m_cells_ptr = cells_ptr;
+	return true;
 }
 
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+inline void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::run_worker_task_sub(task_cell& current_task, std::size_t thread_number)
+{
+#ifndef WELP_THREADS_NO_TELEMETRY
+	worker_stats& stats = *(m_worker_stats_ptr + thread_number);
+	if (m_telemetry_on.load(std::memory_order_relaxed))
+	{
+		std::int64_t start_time = telemetry_time_sub();
+		if (current_task.m_queued_time != 0)
+		{
+			std::uint64_t wait_time = static_cast<std::uint64_t>((start_time > current_task.m_queued_time) ? start_time - current_task.m_queued_time : 0);
+			std::size_t bucket = 0;
+			for (wait_time >>= 10; (wait_time != 0) && (bucket + 1 < WELP_THREADS_HISTOGRAM_SIZE); wait_time >>= 1)
+			{
+				bucket++;
+			}
+			worker_stats::add_sub(stats.m_wait_histogram[bucket], 1);
+		}
+		if (stats.m_last_end_time != 0)
+		{
+			worker_stats::add_sub(stats.m_idle_ns, static_cast<std::uint64_t>(start_time - stats.m_last_end_time));
+		}
+
+		run_task_sub(current_task);
+
+		stats.m_last_end_time = telemetry_time_sub();
+		worker_stats::add_sub(stats.m_busy_ns, static_cast<std::uint64_t>(stats.m_last_end_time - start_time));
+	}
+	else
+	{
+		run_task_sub(current_task);
+		stats.m_last_end_time = 0;
+	}
+	worker_stats::add_sub(stats.m_tasks_run, 1);
+#else
+	(void)thread_number;
+	run_task_sub(current_task);
+#endif // WELP_THREADS_NO_TELEMETRY
+}
 
-template <class _Allocator>
-inline bool welp::threads<_Allocator>::owns_resources() const noexcept
+// a thread of the pool helping from parallel_for also steals, only the threads of the pool count their steals
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+inline void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::count_steal_sub() noexcept
 {
-	return m_number_of_threads != 0;
+#ifndef WELP_THREADS_NO_TELEMETRY
+	if (is_local_worker_sub())
+	{
+		worker_stats::add_sub((m_worker_stats_ptr + local_identity_sub().thread_number)->m_steals, 1);
+	}
+#endif // WELP_THREADS_NO_TELEMETRY
 }
 
-template <class _Allocator>
-inline std::size_t welp::threads<_Allocator>::number_of_threads() const noexcept
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+inline std::int64_t welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::telemetry_time_sub() noexcept
 {
-	return m_number_of_threads;
+	return static_cast<std::int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count());
 }
 
-template <class _Allocator>
-inline std::size_t welp::threads<_Allocator>::task_buffer_size() const noexcept
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::add_stats_sub(welp::threads_snapshot& stats, std::size_t thread_number) const noexcept
 {
-	if (m_task_buffer_data_ptr != nullptr)
-	{
-		return static_cast<std::size_t>(m_task_buffer_end_ptr - m_task_buffer_data_ptr) - 1;
-	}
-	else
+	const worker_stats& thread_stats = *(m_worker_stats_ptr + thread_number);
+	stats.tasks_run += thread_stats.m_tasks_run.load(std::memory_order_relaxed);
+	stats.steals += thread_stats.m_steals.load(std::memory_order_relaxed);
+	stats.busy_ns += thread_stats.m_busy_ns.load(std::memory_order_relaxed);
+	stats.idle_ns += thread_stats.m_idle_ns.load(std::memory_order_relaxed);
+	for (std::size_t k = 0; k < WELP_THREADS_HISTOGRAM_SIZE; k++)
 	{
-		return 0;
+		stats.wait_histogram[k] += thread_stats.m_wait_histogram[k].load(std::memory_order_relaxed);
 	}
 }
 
-
-template <class _Allocator>
-bool welp::threads<_Allocator>::new_threads(std::size_t input_number_of_threads, std::size_t input_task_buffer_size)
+// the node is destroyed if it can't be stored in the heap
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::schedule_sub(timed_node* node_ptr)
 {
-	delete_threads();
-	m_stop_threads = false;
-
-	if ((input_number_of_threads == 0) || (input_task_buffer_size == 0))
+	bool earliest_deadline = false;
+	std::unique_lock<std::mutex> timer_lock(m_timer_mutex);
+	if (!insert_timed_node_sub(node_ptr, earliest_deadline))
 	{
+		delete_timed_node_sub(node_ptr);
 		return false;
 	}
+	timer_lock.unlock();
 
-	input_task_buffer_size = (input_number_of_threads > input_task_buffer_size) ? input_number_of_threads : input_task_buffer_size;
-
-	try
+	// a sleeping thread has to sleep again until the new deadline
+	if (earliest_deadline)
 	{
-		m_threads_data_ptr = static_cast<std::thread*>(static_cast<void*>(
-			this->allocate(input_number_of_threads * sizeof(std::thread))));
-		if (m_threads_data_ptr == nullptr) { delete_threads(); return false; }
-		m_number_of_threads = input_number_of_threads;
-
-		m_task_buffer_data_ptr = static_cast<std::function<void()>*>(static_cast<void*>(
-			this->allocate((input_task_buffer_size + 1) * sizeof(std::function<void()>))));
-		if (m_task_buffer_data_ptr == nullptr) { delete_threads(); return false; }
-		std::size_t input_task_buffer_size_p1 = input_task_buffer_size + 1;
-		m_task_buffer_end_ptr = m_task_buffer_data_ptr + input_task_buffer_size_p1;
-		m_next_task_ptr = m_task_buffer_data_ptr;
-		m_last_task_ptr = m_task_buffer_data_ptr;
+		m_timer_epoch.fetch_add(1);
+		wake_threads_sub(1);
+	}
+	return true;
+}
 
-		for (std::size_t k = 0; k < input_task_buffer_size_p1; k++)
+// only called with m_timer_mutex locked
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::insert_timed_node_sub(timed_node* node_ptr, bool& earliest_deadline)
+{
+	std::size_t timed_task_count = m_timed_task_count.load(std::memory_order_relaxed);
+	if (timed_task_count == m_timed_nodes_capacity)
+	{
+		std::size_t new_capacity = (m_timed_nodes_capacity != 0) ? 2 * m_timed_nodes_capacity : 16;
+		timed_node** new_nodes_ptr = static_cast<timed_node**>(static_cast<void*>(this->allocate(new_capacity * sizeof(timed_node*))));
+		if (new_nodes_ptr == nullptr)
 		{
-			new (m_task_buffer_data_ptr + k) std::function<void()>();
+			return false;
 		}
-
-		for (std::size_t k = 0; k < input_number_of_threads; k++)
+		for (std::size_t k = 0; k < timed_task_count; k++)
 		{
-			new (m_threads_data_ptr + k) std::thread([=]()
-				{
-					std::function<void()>* current_task_ptr;
-
-					while (true)
-					{
-						{
-							std::unique_lock<std::mutex> lock(m_mutex);
-							m_condition_var.wait(lock, [=]() { return m_last_task_ptr != m_next_task_ptr || m_stop_threads; });
-
-							if (m_last_task_ptr != m_next_task_ptr)
-							{
-								current_task_ptr = m_next_task_ptr++;
-								if (m_next_task_ptr == m_task_buffer_end_ptr)
-								{
-									m_next_task_ptr = m_task_buffer_data_ptr;
-								}
-								m_waiting_tasks.fetch_sub(std::memory_order_release);
-							}
-							else
-							{
-								return;
-							}
-						}
-
-						current_task_ptr->operator()();
-						m_unfinished_tasks.fetch_sub(std::memory_order_release);
-
-#ifdef WELP_THREADS_DEBUG_MODE
-						if (m_DEBUG_record_on)
-						{
-							m_DEBUG_record_completed_task_count.fetch_add(1);
-						}
-#endif // WELP_THREADS_DEBUG_MODE
-					}
-				}
-			);
+			*(new_nodes_ptr + k) = *(m_timed_nodes_ptr + k);
 		}
-	}
-	catch (...)
-	{
-		delete_threads(); return false;
-	}
-
-	for (std::size_t k = 0; k < input_number_of_threads; k++)
-	{
-		if (!((m_threads_data_ptr + k)->joinable()))
+		if (m_timed_nodes_ptr != nullptr)
 		{
-			delete_threads(); return false;
+			this->deallocate(static_cast<char*>(static_cast<void*>(m_timed_nodes_ptr)), m_timed_nodes_capacity * sizeof(timed_node*));
 		}
+		m_timed_nodes_ptr = new_nodes_ptr;
+		m_timed_nodes_capacity = new_capacity;
 	}
 
+	*(m_timed_nodes_ptr + timed_task_count) = node_ptr;
+	std::push_heap(m_timed_nodes_ptr, m_timed_nodes_ptr + timed_task_count + 1, &later_deadline_sub);
+	m_timed_task_count.store(timed_task_count + 1);
+	earliest_deadline = (*m_timed_nodes_ptr == node_ptr);
+	update_next_deadline_sub();
 	return true;
 }
 
-template <class _Allocator>
-void welp::threads<_Allocator>::delete_threads() noexcept
+// a due task stays in the heap if the queue is full and is queued again next time
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::dispatch_timed_tasks_sub()
 {
+	std::int64_t now = static_cast<std::int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count());
+	if ((now < m_next_deadline.load(std::memory_order_relaxed)) || reinterpret_cast<std::atomic<bool>&>(m_stop_threads).load(std::memory_order_relaxed))
 	{
-		std::unique_lock<std::mutex> lock(m_mutex);
-		reinterpret_cast<std::atomic<bool>&>(m_stop_threads).store(true);
+		return;
 	}
 
-	m_condition_var.notify_all();
-
-	if (m_threads_data_ptr != nullptr)
+	std::unique_lock<std::mutex> timer_lock(m_timer_mutex, std::try_to_lock);
+	if (!timer_lock.owns_lock())
 	{
-		for (size_t k = 0; k < m_number_of_threads; k++)
-		{
-			if ((m_threads_data_ptr + k)->joinable())
-			{
-				(m_threads_data_ptr + k)->join();
-			}
-			(m_threads_data_ptr + k)->~thread();
-		}
-		this->deallocate(static_cast<char*>(static_cast<void*>(m_threads_data_ptr)), m_number_of_threads * sizeof(std::thread));
+		return;
 	}
 
-	if (m_task_buffer_data_ptr != nullptr)
+	std::chrono::steady_clock::time_point now_time_point = std::chrono::steady_clock::now();
+	std::size_t timed_task_count = m_timed_task_count.load(std::memory_order_relaxed);
+	// a timed task run inline would lock m_timer_mutex again, so a full queue leaves it in the heap for the next dispatch
+	welp::threads_overflow overflow_policy = (m_overflow_policy == welp::threads_overflow::run_inline) ?
+		welp::threads_overflow::reject : m_overflow_policy;
+	while ((timed_task_count != 0) && ((*m_timed_nodes_ptr)->m_deadline <= now_time_point))
 	{
-		std::size_t task_buffer_size = static_cast<std::size_t>(m_task_buffer_end_ptr - m_task_buffer_data_ptr);
-		for (size_t k = 0; k < task_buffer_size; k++)
+		task_cell new_task;
+		new_task.store(timed_task(this, *m_timed_nodes_ptr), static_cast<_Allocator&>(*this));
+		if (!push_task_sub(new_task, m_number_of_levels - 1, overflow_policy))
 		{
-			(m_task_buffer_data_ptr + k)->~function();
+			break;
 		}
-		this->deallocate(static_cast<char*>(static_cast<void*>(m_task_buffer_data_ptr)), task_buffer_size * sizeof(std::function<void()>));
+		std::pop_heap(m_timed_nodes_ptr, m_timed_nodes_ptr + timed_task_count, &later_deadline_sub);
+		timed_task_count--;
+		m_timed_task_count.store(timed_task_count);
 	}
-
-	m_threads_data_ptr = nullptr;
-	m_number_of_threads = 0;
-
-	m_task_buffer_data_ptr = nullptr;
-	m_task_buffer_end_ptr = static_cast<std::function<void()>*>(nullptr) + 1;
-	m_next_task_ptr = nullptr;
-	m_last_task_ptr = static_cast<std::function<void()>*>(nullptr) + 1;
-}
-
-
-#ifdef WELP_THREADS_DEBUG_MODE
-template <class _Allocator>
-void welp::threads<_Allocator>::DEBUG_reset_record() noexcept
-{
-	m_DEBUG_record_max_occupancy.store(0);
-	m_DEBUG_record_completed_task_count.store(0);
-	m_DEBUG_record_accepted_task_count = 0;
-	m_DEBUG_record_denied_task_count = 0;
-	m_DEBUG_record_delayed_task_count.store(0);
-	m_DEBUG_record_on = false;
-}
-
-template <class _Allocator>
-void welp::threads<_Allocator>::DEBUG_say_sub()
-{
-	std::cout << "\nThreads   > number of threads : " << m_number_of_threads
-		<< "   > task buffer size : " << ((m_task_buffer_data_ptr != nullptr) ? static_cast<std::size_t>(m_task_buffer_end_ptr - m_task_buffer_data_ptr) - 1 : 0)
-		<< "\n          > tasks accepted : " << m_DEBUG_record_accepted_task_count
-		<< "   > tasks accepted with delay : " << m_DEBUG_record_delayed_task_count.load()
-		<< "   > tasks denied : " << m_DEBUG_record_denied_task_count
-		<< "\n          > tasks completed : " << m_DEBUG_record_completed_task_count.load()
-		<< "   > currently unfinished tasks : " << m_unfinished_tasks.load()
-		<< "\n          > maximum occupancy recorded in task buffer : " << m_DEBUG_record_max_occupancy.load() << "\n" << std::endl;
-}
-
-template <class _Allocator>
-void welp::threads<_Allocator>::DEBUG_say()
-{
-	std::lock_guard<std::mutex> lock(m_mutex);
-	DEBUG_say_sub();
-}
-
-template <class _Allocator> template <typename msg_Ty>
-void welp::threads<_Allocator>::DEBUG_say(const msg_Ty& msg)
-{
-	std::lock_guard<std::mutex> lock(m_mutex);
-	std::cout << "[ " << msg << " ]\n"; DEBUG_say_sub();
-}
-
-template <class _Allocator> template <typename msg_Ty1, typename msg_Ty2>
-void welp::threads<_Allocator>::DEBUG_say(const msg_Ty1& msg1, const msg_Ty2& msg2)
-{
-	std::lock_guard<std::mutex> lock(m_mutex);
-	std::cout << "[ " << msg1 << " " << msg2 << " ]\n"; DEBUG_say_sub();
+	update_next_deadline_sub();
 }
 
-template <class _Allocator> template <typename msg_Ty1, typename msg_Ty2, typename msg_Ty3>
-void welp::threads<_Allocator>::DEBUG_say(const msg_Ty1& msg1, const msg_Ty2& msg2, const msg_Ty3& msg3)
+// a recurring task goes back to the heap after each run unless it was cancelled meanwhile
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::run_timed_node_sub(timed_node* node_ptr)
 {
-	std::lock_guard<std::mutex> lock(m_mutex);
-	std::cout << "[ " << msg1 << " " << msg2 << " " << msg3 << " ]\n"; DEBUG_say_sub();
-}
+	node_ptr->m_task.invoke();
 
-template <class _Allocator> template <typename msg_Ty1, typename msg_Ty2, typename msg_Ty3, typename msg_Ty4>
-void welp::threads<_Allocator>::DEBUG_say(const msg_Ty1& msg1, const msg_Ty2& msg2, const msg_Ty3& msg3, const msg_Ty4& msg4)
-{
-	std::lock_guard<std::mutex> lock(m_mutex);
-	std::cout << "[ " << msg1 << " " << msg2 << " " << msg3 << " " << msg4 << " ]\n"; DEBUG_say_sub();
-}
+	std::unique_lock<std::mutex> timer_lock(m_timer_mutex);
+	bool earliest_deadline = false;
+	if ((node_ptr->m_period.count() == 0) || node_ptr->m_cancelled)
+	{
+		delete_timed_node_sub(node_ptr);
+		return;
+	}
 
+	std::chrono::steady_clock::time_point now_time_point = std::chrono::steady_clock::now();
+	node_ptr->m_deadline += node_ptr->m_period;
+	if (node_ptr->m_deadline < now_time_point)
+	{
+		node_ptr->m_deadline = now_time_point;
+	}
+	if (!insert_timed_node_sub(node_ptr, earliest_deadline))
+	{
+		delete_timed_node_sub(node_ptr);
+		return;
+	}
+	timer_lock.unlock();
 
-#ifdef WELP_THREADS_INCLUDE_FSTREAM
-template <class _Allocator>
-void welp::threads<_Allocator>::DEBUG_write_sub(std::ofstream& rec_write)
-{
-	rec_write << "\nThreads   > number of threads : " << m_number_of_threads
-		<< "   > task buffer size : " << ((m_task_buffer_data_ptr != nullptr) ? static_cast<std::size_t>(m_task_buffer_end_ptr - m_task_buffer_data_ptr) - 1 : 0)
-		<< "\n     > tasks accepted : " << m_DEBUG_record_accepted_task_count
-		<< "   > tasks accepted with delay : " << m_DEBUG_record_delayed_task_count.load()
-		<< "   > tasks denied : " << m_DEBUG_record_denied_task_count
-		<< "\n     > tasks completed : " << m_DEBUG_record_completed_task_count.load()
-		<< "   > currently unfinished tasks : " << m_unfinished_tasks.load()
-		<< "\n     > maximum occupancy recorded in task buffer : " << m_DEBUG_record_max_occupancy.load() << "\n" << std::endl;
+	if (earliest_deadline)
+	{
+		m_timer_epoch.fetch_add(1);
+		wake_threads_sub(1);
+	}
 }
 
-template <class _Allocator>
-void welp::threads<_Allocator>::DEBUG_write(const char* const filename)
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::delete_timed_node_sub(timed_node* node_ptr) noexcept
 {
-	std::lock_guard<std::mutex> lock(m_mutex);
-	std::ofstream rec_write;
-	rec_write.open(filename, std::ios::app);
-	DEBUG_write_sub(rec_write);
-	rec_write.close();
-}
+	void* box_ptr = node_ptr->m_box_ptr;
+	void (*finish_ptr)(void*) = node_ptr->m_finish_ptr;
 
-template <class _Allocator> template <typename msg_Ty>
-void welp::threads<_Allocator>::DEBUG_write(const char* const filename, const msg_Ty& msg)
-{
-	std::lock_guard<std::mutex> lock(m_mutex);
-	std::ofstream rec_write;
-	rec_write.open(filename, std::ios::app);
-	rec_write << "[ " << msg << " ]\n";
-	DEBUG_write_sub(rec_write);
-	rec_write.close();
-}
+	node_ptr->~timed_node();
+	this->deallocate(static_cast<char*>(static_cast<void*>(node_ptr)), sizeof(timed_node));
 
-template <class _Allocator> template <typename msg_Ty1, typename msg_Ty2>
-void welp::threads<_Allocator>::DEBUG_write(const char* const filename, const msg_Ty1& msg1, const msg_Ty2& msg2)
-{
-	std::lock_guard<std::mutex> lock(m_mutex);
-	std::ofstream rec_write;
-	rec_write.open(filename, std::ios::app);
-	rec_write << "[ " << msg1 << " " << msg2 << " ]\n";
-	DEBUG_write_sub(rec_write);
-	rec_write.close();
+	if (finish_ptr != nullptr)
+	{
+		finish_ptr(box_ptr);
+	}
 }
 
-template <class _Allocator> template <typename msg_Ty1, typename msg_Ty2, typename msg_Ty3>
-void welp::threads<_Allocator>::DEBUG_write(const char* const filename, const msg_Ty1& msg1, const msg_Ty2& msg2, const msg_Ty3& msg3)
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+inline void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::update_next_deadline_sub() noexcept
 {
-	std::lock_guard<std::mutex> lock(m_mutex);
-	std::ofstream rec_write;
-	rec_write.open(filename, std::ios::app);
-	rec_write << "[ " << msg1 << " " << msg2 << " " << msg3 << " ]\n";
-	DEBUG_write_sub(rec_write);
-	rec_write.close();
+	if (m_timed_task_count.load(std::memory_order_relaxed) != 0)
+	{
+		m_next_deadline.store(static_cast<std::int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			(*m_timed_nodes_ptr)->m_deadline.time_since_epoch()).count()));
+	}
+	else
+	{
+		m_next_deadline.store(INT64_MAX);
+	}
 }
 
-template <class _Allocator> template <typename msg_Ty1, typename msg_Ty2, typename msg_Ty3, typename msg_Ty4>
-void welp::threads<_Allocator>::DEBUG_write(const char* const filename, const msg_Ty1& msg1, const msg_Ty2& msg2, const msg_Ty3& msg3, const msg_Ty4& msg4)
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+inline bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::later_deadline_sub(const timed_node* lhs_ptr, const timed_node* rhs_ptr) noexcept
 {
-	std::lock_guard<std::mutex> lock(m_mutex);
-	std::ofstream rec_write;
-	rec_write.open(filename, std::ios::app);
-	rec_write << "[ " << msg1 << " " << msg2 << " " << msg3 << " " << msg4 << " ]\n";
-	DEBUG_write_sub(rec_write);
-	rec_write.close();
+	return lhs_ptr->m_deadline > rhs_ptr->m_deadline;
 }
-#endif // WELP_THREADS_INCLUDE_FSTREAM
-#endif // WELP_THREADS_DEBUG_MODE
 
-
-template <class _Allocator> template <class function_Ty, class ... _Args>
-bool welp::threads<_Allocator>::force_async_task_sub(const function_Ty& task, _Args&& ... args)
+// a node in the heap is destroyed right away, a node being queued or run is destroyed once its run is over
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class box_wait_Ty>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::cancel_recurring_sub(void* pool_ptr, welp::basic_recurring_task<box_wait_Ty>* box_ptr)
 {
-	while (m_waiting_for_finish.load(std::memory_order_relaxed)) {}
-	std::unique_lock<std::mutex> lock(m_mutex);
-
-	if ((m_last_task_ptr + 1 != m_next_task_ptr) &&
-		((m_next_task_ptr != m_task_buffer_data_ptr) || (m_last_task_ptr + 1 != m_task_buffer_end_ptr)))
+	welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>* this_ptr = static_cast<welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>*>(pool_ptr);
+	std::lock_guard<std::mutex> timer_lock(this_ptr->m_timer_mutex);
+	if (!box_ptr->m_scheduled.load(std::memory_order_acquire))
 	{
-		m_waiting_tasks.fetch_add(1, std::memory_order_acquire);
-		m_unfinished_tasks.fetch_add(1, std::memory_order_acquire);
+		return;
+	}
 
-		try
-		{
-			*m_last_task_ptr = [&]()
-			{
-				task(std::forward<_Args>(args)...);
-			};
-		}
-		catch (...)
-		{
-			m_waiting_tasks.fetch_sub(1, std::memory_order_release);
-			m_unfinished_tasks.fetch_sub(1, std::memory_order_release);
-			return false;
-		}
+	timed_node* node_ptr = static_cast<timed_node*>(box_ptr->m_node_ptr);
+	node_ptr->m_cancelled = true;
 
-		m_last_task_ptr++;
-		if (m_last_task_ptr == m_task_buffer_end_ptr)
+	std::size_t timed_task_count = this_ptr->m_timed_task_count.load(std::memory_order_relaxed);
+	for (std::size_t k = 0; k < timed_task_count; k++)
+	{
+		if (*(this_ptr->m_timed_nodes_ptr + k) == node_ptr)
 		{
-			m_last_task_ptr = m_task_buffer_data_ptr;
+			*(this_ptr->m_timed_nodes_ptr + k) = *(this_ptr->m_timed_nodes_ptr + timed_task_count - 1);
+			std::make_heap(this_ptr->m_timed_nodes_ptr, this_ptr->m_timed_nodes_ptr + timed_task_count - 1, &later_deadline_sub);
+			this_ptr->m_timed_task_count.store(timed_task_count - 1);
+			this_ptr->update_next_deadline_sub();
+			this_ptr->delete_timed_node_sub(node_ptr);
+			return;
 		}
+	}
+}
 
-		m_condition_var.notify_one();
-
-#ifdef WELP_THREADS_DEBUG_MODE
-		if (m_DEBUG_record_on)
-		{
-			m_DEBUG_record_accepted_task_count++;
-			std::size_t temp = m_waiting_tasks.load();
-			if (temp > m_DEBUG_record_max_occupancy.load())
-			{
-				m_DEBUG_record_max_occupancy.store(temp);
-			}
-		}
-#endif // WELP_THREADS_DEBUG_MODE
+// the box can be destroyed as soon as m_scheduled is false, the notification only uses its address
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty> template <class box_wait_Ty>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::finish_recurring_sub(void* box_ptr) noexcept
+{
+	welp::basic_recurring_task<box_wait_Ty>* recurring_box_ptr = static_cast<welp::basic_recurring_task<box_wait_Ty>*>(box_ptr);
+	const void* address = &recurring_box_ptr->m_scheduled;
+	recurring_box_ptr->m_scheduled.store(false, std::memory_order_release);
+	box_wait_Ty::notify_all(address);
+}
 
-		return true;
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::new_ring_sub(task_ring& ring, std::size_t ring_capacity)
+{
+	// at least 2 cells, with a single cell the sequence numbers of a full cell and of a free cell would be the same
+	std::size_t rounded_capacity = 2;
+	while (rounded_capacity < ring_capacity)
+	{
+		rounded_capacity <<= 1;
 	}
-	else
+
+	ring.m_cells_ptr = static_cast<typename task_ring::ring_cell*>(static_cast<void*>(
+		this->allocate(rounded_capacity * sizeof(typename task_ring::ring_cell))));
+	if (ring.m_cells_ptr == nullptr)
 	{
 		return false;
 	}
+	ring.m_mask = rounded_capacity - 1;
+
+	for (std::size_t k = 0; k < rounded_capacity; k++)
+	{
+		new (ring.m_cells_ptr + k) typename task_ring::ring_cell();
+		(ring.m_cells_ptr + k)->m_sequence.store(k, std::memory_order_relaxed);
+	}
+	return true;
 }
 
-template <class _Allocator> template <class function_Ty, class ... _Args>
-bool welp::threads<_Allocator>::force_priority_async_task_sub(const function_Ty& task, _Args&& ... args)
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::delete_ring_sub(task_ring& ring) noexcept
 {
-	while (m_waiting_for_finish.load(std::memory_order_relaxed)) {}
-	std::unique_lock<std::mutex> lock(m_mutex);
-
-	if ((m_last_task_ptr + 1 != m_next_task_ptr) &&
-		((m_next_task_ptr != m_task_buffer_data_ptr) || (m_last_task_ptr + 1 != m_task_buffer_end_ptr)))
+	if (ring.m_cells_ptr != nullptr)
 	{
-		m_waiting_tasks.fetch_add(1, std::memory_order_acquire);
-		m_unfinished_tasks.fetch_add(1, std::memory_order_acquire);
-
-		try
-		{
-			if (m_next_task_ptr != m_task_buffer_data_ptr)
-			{
-				*(m_next_task_ptr - 1) = [&]()
-				{
-					task(std::forward<_Args>(args)...);
-				};
-				m_next_task_ptr--;
-			}
-			else
-			{
-				*(m_task_buffer_end_ptr - 1) = [&]()
-				{
-					task(std::forward<_Args>(args)...);
-				};
-				m_next_task_ptr = m_task_buffer_end_ptr - 1;
-			}
-		}
-		catch (...)
+		std::size_t ring_capacity = ring.m_mask + 1;
+		for (std::size_t k = 0; k < ring_capacity; k++)
 		{
-			m_waiting_tasks.fetch_sub(1, std::memory_order_release);
-			m_unfinished_tasks.fetch_sub(1, std::memory_order_release);
-			return false;
+			(ring.m_cells_ptr + k)->~ring_cell();
 		}
+		this->deallocate(static_cast<char*>(static_cast<void*>(ring.m_cells_ptr)), ring_capacity * sizeof(typename task_ring::ring_cell));
+	}
+	ring.~task_ring();
+	new (&ring) task_ring();
+}
 
-		m_condition_var.notify_one();
 
-#ifdef WELP_THREADS_DEBUG_MODE
-		if (m_DEBUG_record_on)
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+void welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::pin_thread_sub(std::size_t thread_number) noexcept
+{
+#ifdef WELP_THREADS_LINUX_AFFINITY
+	std::size_t slot = thread_number % m_affinity_ptr->m_number_of_slots;
+	cpu_set_t thread_cpus;
+	CPU_ZERO(&thread_cpus);
+	if (m_affinity_ptr->m_slot_cpus[slot] >= 0)
+	{
+		CPU_SET(m_affinity_ptr->m_slot_cpus[slot], &thread_cpus);
+	}
+	else
+	{
+		for (int cpu = 0; (cpu < WELP_THREADS_MAX_CPUS) && (cpu < CPU_SETSIZE); cpu++)
 		{
-			m_DEBUG_record_accepted_task_count++;
-			std::size_t temp = m_waiting_tasks.load();
-			if (temp > m_DEBUG_record_max_occupancy.load())
+			if (m_affinity_ptr->m_cpu_nodes[cpu] == static_cast<int>(m_affinity_ptr->m_slot_nodes[slot]))
 			{
-				m_DEBUG_record_max_occupancy.store(temp);
+				CPU_SET(cpu, &thread_cpus);
 			}
 		}
-#endif // WELP_THREADS_DEBUG_MODE
+	}
+	pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &thread_cpus);
+#else
+	(void)thread_number;
+#endif // WELP_THREADS_LINUX_AFFINITY
+}
 
-		return true;
+// returns m_number_of_nodes if the node of the calling thread is not known
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+inline std::size_t welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::local_node_sub() const noexcept
+{
+	if (is_local_worker_sub())
+	{
+		return local_identity_sub().node_number;
 	}
-	else
+#ifdef WELP_THREADS_LINUX_AFFINITY
+	int cpu = sched_getcpu();
+	if ((cpu >= 0) && (cpu < WELP_THREADS_MAX_CPUS) && (m_affinity_ptr->m_cpu_nodes[cpu] >= 0))
 	{
-		return false;
+		return static_cast<std::size_t>(m_affinity_ptr->m_cpu_nodes[cpu]);
 	}
+#endif // WELP_THREADS_LINUX_AFFINITY
+	return m_number_of_nodes;
 }
 
-template <class _Allocator> template <class function_Ty, class ... _Args>
-bool welp::threads<_Allocator>::force_async_task_sub(welp::async_task_end& box, const function_Ty& task, _Args&& ... args)
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+inline bool welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::is_local_worker_sub() const noexcept
 {
-	while (m_waiting_for_finish.load(std::memory_order_relaxed)) {}
-	std::unique_lock<std::mutex> lock(m_mutex);
+	return local_identity_sub().pool_ptr == static_cast<const void*>(this);
+}
 
-	if ((m_last_task_ptr + 1 != m_next_task_ptr) &&
-		((m_next_task_ptr != m_task_buffer_data_ptr) || (m_last_task_ptr + 1 != m_task_buffer_end_ptr)) &&
-		!box.m_task_running.load(std::memory_order_acquire))
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+inline typename welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::worker_deque*
+welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::local_deque_sub() const noexcept
+{
+	if (work_stealing && is_local_worker_sub())
 	{
-		m_waiting_tasks.fetch_add(1, std::memory_order_acquire);
-		m_unfinished_tasks.fetch_add(1, std::memory_order_acquire);
-		box.m_task_running.store(true, std::memory_order_acquire);
-		box.m_task_denied.store(false, std::memory_order_acquire);
-
-		try
-		{
-			*m_last_task_ptr = [&]()
-			{
-				task(std::forward<_Args>(args)...);
-				box.m_task_running.store(false, std::memory_order_release);
-			};
-		}
-		catch (...)
-		{
-			m_waiting_tasks.fetch_sub(1, std::memory_order_release);
-			m_unfinished_tasks.fetch_sub(1, std::memory_order_release);
-			box.m_task_running.store(true, std::memory_order_release);
-			box.m_task_denied.store(true, std::memory_order_release);
-			return false;
-		}
+		return m_worker_deques_ptr + local_identity_sub().thread_number;
+	}
+	else
+	{
+		return nullptr;
+	}
+}
 
-		m_last_task_ptr++;
-		if (m_last_task_ptr == m_task_buffer_end_ptr)
-		{
-			m_last_task_ptr = m_task_buffer_data_ptr;
-		}
+template <class _Allocator, bool work_stealing, std::size_t task_cell_size, class wait_Ty>
+inline typename welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::worker_identity&
+welp::threads<_Allocator, work_stealing, task_cell_size, wait_Ty>::local_identity_sub() noexcept
+{
+	static thread_local worker_identity identity;
+	return identity;
+}
 
-		m_condition_var.notify_one();
 
-#ifdef WELP_THREADS_DEBUG_MODE
-		if (m_DEBUG_record_on)
-		{
-			m_DEBUG_record_accepted_task_count++;
-			std::size_t temp = m_waiting_tasks.load();
-			if (temp > m_DEBUG_record_max_occupancy.load())
-			{
-				m_DEBUG_record_max_occupancy.store(temp);
-			}
-		}
-#endif // WELP_THREADS_DEBUG_MODE
+template <class threads_Ty> template <class function_Ty, class ... _Args>
+bool welp::task_graph<threads_Ty>::add_task(std::size_t& task_index, function_Ty&& task, _Args&& ... args)
+{
+	if ((m_number_of_tasks == m_max_number_of_tasks) || !is_done())
+	{
+		return false;
+	}
 
-		return true;
+	try
+	{
+		// the arguments are passed as lvalues since the task runs every time the graph runs
+		(m_nodes_ptr + m_number_of_tasks)->m_task.store(typename threads_Ty::template repeated_task_type<function_Ty, _Args...>(
+			std::forward<function_Ty>(task), std::forward<_Args>(args)...), static_cast<typename threads_Ty::allocator_type&>(*this));
 	}
-	else
+	catch (...)
 	{
-		box.m_task_denied.store(true, std::memory_order_release);
 		return false;
 	}
+
+	task_index = m_number_of_tasks;
+	m_number_of_tasks++;
+	m_graph_sorted = false;
+	return true;
 }
 
-template <class _Allocator> template <class function_Ty, class ... _Args>
-bool welp::threads<_Allocator>::force_priority_async_task_sub(welp::async_task_end& box, const function_Ty& task, _Args&& ... args)
+template <class threads_Ty>
+bool welp::task_graph<threads_Ty>::add_dependency(std::size_t first_task_index, std::size_t next_task_index) noexcept
 {
-	while (m_waiting_for_finish.load(std::memory_order_relaxed)) {}
-	std::unique_lock<std::mutex> lock(m_mutex);
+	if ((m_number_of_dependencies == m_max_number_of_dependencies) || (first_task_index >= m_number_of_tasks)
+		|| (next_task_index >= m_number_of_tasks) || (first_task_index == next_task_index) || !is_done())
+	{
+		return false;
+	}
+
+	(m_dependencies_ptr + m_number_of_dependencies)->first_task_index = first_task_index;
+	(m_dependencies_ptr + m_number_of_dependencies)->next_task_index = next_task_index;
+	m_number_of_dependencies++;
+	m_graph_sorted = false;
+	return true;
+}
 
+template <class threads_Ty>
+bool welp::task_graph<threads_Ty>::run(threads_Ty& pool)
+{
+	if (!is_done() || (m_number_of_tasks == 0))
+	{
+		return is_done();
+	}
+	if ((pool.task_buffer_size() == 0) || (!m_graph_sorted && !sort_graph_sub()))
+	{
+		return false;
+	}
 
-	if ((m_last_task_ptr + 1 != m_next_task_ptr) &&
-		((m_next_task_ptr != m_task_buffer_data_ptr) || (m_last_task_ptr + 1 != m_task_buffer_end_ptr)) &&
-		!box.m_task_running.load(std::memory_order_acquire))
+	m_pool_ptr = &pool;
+	for (std::size_t k = 0; k < m_number_of_tasks; k++)
 	{
-		m_waiting_tasks.fetch_add(1, std::memory_order_acquire);
-		m_unfinished_tasks.fetch_add(1, std::memory_order_acquire);
-		box.m_task_running.store(true, std::memory_order_acquire);
-		box.m_task_denied.store(false, std::memory_order_acquire);
+		(m_nodes_ptr + k)->m_pending_predecessors.store((m_nodes_ptr + k)->m_number_of_predecessors, std::memory_order_relaxed);
+	}
+	m_remaining_tasks.store(m_number_of_tasks, std::memory_order_release);
 
-		try
-		{
-			if (m_next_task_ptr != m_task_buffer_data_ptr)
-			{
-				*(m_next_task_ptr - 1) = [&]()
-				{
-					task(std::forward<_Args>(args)...);
-					box.m_task_running.store(false, std::memory_order_release);
-				};
-				m_next_task_ptr--;
-			}
-			else
-			{
-				*(m_task_buffer_end_ptr - 1) = [&]()
-				{
-					task(std::forward<_Args>(args)...);
-					box.m_task_running.store(false, std::memory_order_release);
-				};
-				m_next_task_ptr = m_task_buffer_end_ptr - 1;
-			}
-		}
-		catch (...)
+	for (std::size_t k = 0; k < m_number_of_tasks; k++)
+	{
+		if ((m_nodes_ptr + k)->m_number_of_predecessors == 0)
 		{
-			m_waiting_tasks.fetch_sub(1, std::memory_order_release);
-			m_unfinished_tasks.fetch_sub(1, std::memory_order_release);
-			box.m_task_running.store(false, std::memory_order_release);
-			box.m_task_denied.store(true, std::memory_order_release);
-			return false;
+			queue_task_sub(k);
 		}
+	}
+	return true;
+}
 
-		m_condition_var.notify_one();
+template <class threads_Ty>
+inline void welp::task_graph<threads_Ty>::wait() const noexcept
+{
+	threads_Ty::wait_type::wait_until(&m_remaining_tasks, [this]() { return m_remaining_tasks.load(std::memory_order_acquire) == 0; });
+}
 
-#ifdef WELP_THREADS_DEBUG_MODE
-		if (m_DEBUG_record_on)
-		{
-			m_DEBUG_record_accepted_task_count++;
-			std::size_t temp = m_waiting_tasks.load();
-			if (temp > m_DEBUG_record_max_occupancy.load())
-			{
-				m_DEBUG_record_max_occupancy.store(temp);
-			}
-		}
-#endif // WELP_THREADS_DEBUG_MODE
+template <class threads_Ty>
+inline bool welp::task_graph<threads_Ty>::is_done() const noexcept
+{
+	return m_remaining_tasks.load(std::memory_order_acquire) == 0;
+}
 
-		return true;
-	}
-	else
-	{
-		box.m_task_denied.store(true, std::memory_order_release);
-		return false;
-	}
+template <class threads_Ty>
+inline std::size_t welp::task_graph<threads_Ty>::number_of_tasks() const noexcept
+{
+	return m_number_of_tasks;
+}
+
+template <class threads_Ty>
+inline std::size_t welp::task_graph<threads_Ty>::number_of_dependencies() const noexcept
+{
+	return m_number_of_dependencies;
 }
 
-template <class _Allocator> template <class return_Ty, class function_Ty, class ... _Args>
-bool welp::threads<_Allocator>::force_async_task_sub(welp::async_task_result<return_Ty>& box, const function_Ty& task, _Args&& ... args)
+template <class threads_Ty>
+inline bool welp::task_graph<threads_Ty>::owns_resources() const noexcept
 {
-	while (m_waiting_for_finish.load(std::memory_order_relaxed)) {}
-	std::unique_lock<std::mutex> lock(m_mutex);
+	return m_nodes_ptr != nullptr;
+}
+
+template <class threads_Ty>
+bool welp::task_graph<threads_Ty>::new_graph(std::size_t max_number_of_tasks, std::size_t max_number_of_dependencies)
+{
+	delete_graph();
 
-	if ((m_last_task_ptr + 1 != m_next_task_ptr) &&
-		((m_next_task_ptr != m_task_buffer_data_ptr) || (m_last_task_ptr + 1 != m_task_buffer_end_ptr)) &&
-		!box.m_task_running.load(std::memory_order_acquire))
+	if (max_number_of_tasks == 0)
 	{
-		m_waiting_tasks.fetch_add(1, std::memory_order_acquire);
-		m_unfinished_tasks.fetch_add(1, std::memory_order_acquire);
-		box.m_task_running.store(true, std::memory_order_acquire);
-		box.m_task_denied.store(false, std::memory_order_acquire);
+		return false;
+	}
 
-		try
-		{
-			*m_last_task_ptr = [&]()
-			{
-				box.m_stored_value = task(std::forward<_Args>(args)...);
-				box.m_task_running.store(false, std::memory_order_release);
-			};
-		}
-		catch (...)
-		{
-			m_waiting_tasks.fetch_sub(1, std::memory_order_release);
-			m_unfinished_tasks.fetch_sub(1, std::memory_order_release);
-			box.m_task_running.store(false, std::memory_order_release);
-			box.m_task_denied.store(true, std::memory_order_release);
-			return false;
-		}
+	m_nodes_ptr = static_cast<graph_node*>(static_cast<void*>(this->allocate(max_number_of_tasks * sizeof(graph_node))));
+	if (m_nodes_ptr == nullptr) { delete_graph(); return false; }
+	for (std::size_t k = 0; k < max_number_of_tasks; k++)
+	{
+		new (m_nodes_ptr + k) graph_node();
+	}
+	m_max_number_of_tasks = max_number_of_tasks;
 
-		m_last_task_ptr++;
-		if (m_last_task_ptr == m_task_buffer_end_ptr)
-		{
-			m_last_task_ptr = m_task_buffer_data_ptr;
-		}
+	m_ready_tasks_ptr = static_cast<std::size_t*>(static_cast<void*>(this->allocate(max_number_of_tasks * sizeof(std::size_t))));
+	if (m_ready_tasks_ptr == nullptr) { delete_graph(); return false; }
 
-		m_condition_var.notify_one();
+	if (max_number_of_dependencies != 0)
+	{
+		m_dependencies_ptr = static_cast<graph_dependency*>(static_cast<void*>(this->allocate(max_number_of_dependencies * sizeof(graph_dependency))));
+		m_successors_ptr = static_cast<std::size_t*>(static_cast<void*>(this->allocate(max_number_of_dependencies * sizeof(std::size_t))));
+		m_max_number_of_dependencies = max_number_of_dependencies;
+		if ((m_dependencies_ptr == nullptr) || (m_successors_ptr == nullptr)) { delete_graph(); return false; }
+	}
 
-#ifdef WELP_THREADS_DEBUG_MODE
-		if (m_DEBUG_record_on)
+	return true;
+}
+
+template <class threads_Ty>
+void welp::task_graph<threads_Ty>::delete_graph() noexcept
+{
+	wait();
+
+	if (m_nodes_ptr != nullptr)
+	{
+		for (std::size_t k = 0; k < m_max_number_of_tasks; k++)
 		{
-			m_DEBUG_record_accepted_task_count++;
-			std::size_t temp = m_waiting_tasks.load();
-			if (temp > m_DEBUG_record_max_occupancy.load())
-			{
-				m_DEBUG_record_max_occupancy.store(temp);
-			}
+			(m_nodes_ptr + k)->~graph_node();
 		}
-#endif // WELP_THREADS_DEBUG_MODE
-
-		return true;
+		this->deallocate(static_cast<char*>(static_cast<void*>(m_nodes_ptr)), m_max_number_of_tasks * sizeof(graph_node));
 	}
-	else
+	if (m_ready_tasks_ptr != nullptr)
 	{
-		box.m_task_denied.store(true, std::memory_order_release);
-		return false;
+		this->deallocate(static_cast<char*>(static_cast<void*>(m_ready_tasks_ptr)), m_max_number_of_tasks * sizeof(std::size_t));
+	}
+	if (m_dependencies_ptr != nullptr)
+	{
+		this->deallocate(static_cast<char*>(static_cast<void*>(m_dependencies_ptr)), m_max_number_of_dependencies * sizeof(graph_dependency));
+	}
+	if (m_successors_ptr != nullptr)
+	{
+		this->deallocate(static_cast<char*>(static_cast<void*>(m_successors_ptr)), m_max_number_of_dependencies * sizeof(std::size_t));
 	}
+
+	m_nodes_ptr = nullptr;
+	m_ready_tasks_ptr = nullptr;
+	m_dependencies_ptr = nullptr;
+	m_successors_ptr = nullptr;
+	m_number_of_tasks = 0;
+	m_max_number_of_tasks = 0;
+	m_number_of_dependencies = 0;
+	m_max_number_of_dependencies = 0;
+	m_graph_sorted = false;
 }
 
-template <class _Allocator> template <class return_Ty, class function_Ty, class ... _Args>
-bool welp::threads<_Allocator>::force_priority_async_task_sub(welp::async_task_result<return_Ty>& box, const function_Ty& task, _Args&& ... args)
+// builds the lists of successors and returns false if the dependencies form a cycle
+template <class threads_Ty>
+bool welp::task_graph<threads_Ty>::sort_graph_sub() noexcept
 {
-	while (m_waiting_for_finish.load(std::memory_order_relaxed)) {}
-	std::unique_lock<std::mutex> lock(m_mutex);
+	for (std::size_t k = 0; k < m_number_of_tasks; k++)
+	{
+		(m_nodes_ptr + k)->m_number_of_predecessors = 0;
+		(m_nodes_ptr + k)->m_number_of_successors = 0;
+	}
+	for (std::size_t k = 0; k < m_number_of_dependencies; k++)
+	{
+		(m_nodes_ptr + (m_dependencies_ptr + k)->first_task_index)->m_number_of_successors++;
+		(m_nodes_ptr + (m_dependencies_ptr + k)->next_task_index)->m_number_of_predecessors++;
+	}
 
-	if ((m_last_task_ptr + 1 != m_next_task_ptr) &&
-		((m_next_task_ptr != m_task_buffer_data_ptr) || (m_last_task_ptr + 1 != m_task_buffer_end_ptr)) &&
-		!box.m_task_running.load(std::memory_order_acquire))
+	std::size_t first_successor = 0;
+	for (std::size_t k = 0; k < m_number_of_tasks; k++)
+	{
+		(m_nodes_ptr + k)->m_first_successor = first_successor;
+		first_successor += (m_nodes_ptr + k)->m_number_of_successors;
+		(m_nodes_ptr + k)->m_number_of_successors = 0;
+	}
+	for (std::size_t k = 0; k < m_number_of_dependencies; k++)
 	{
-		m_waiting_tasks.fetch_add(1, std::memory_order_acquire);
-		m_unfinished_tasks.fetch_add(1, std::memory_order_acquire);
-		box.m_task_running.store(true, std::memory_order_acquire);
-		box.m_task_denied.store(false, std::memory_order_acquire);
+		graph_node* node_ptr = m_nodes_ptr + (m_dependencies_ptr + k)->first_task_index;
+		*(m_successors_ptr + node_ptr->m_first_successor + node_ptr->m_number_of_successors) = (m_dependencies_ptr + k)->next_task_index;
+		node_ptr->m_number_of_successors++;
+	}
 
-		try
+	// every task is reached by removing the tasks without predecessors one by one if there is no cycle
+	std::size_t ready_end = 0;
+	for (std::size_t k = 0; k < m_number_of_tasks; k++)
+	{
+		(m_nodes_ptr + k)->m_pending_predecessors.store((m_nodes_ptr + k)->m_number_of_predecessors, std::memory_order_relaxed);
+		if ((m_nodes_ptr + k)->m_number_of_predecessors == 0)
 		{
-			if (m_next_task_ptr != m_task_buffer_data_ptr)
-			{
-				*(m_next_task_ptr - 1) = [&]()
-				{
-					box.m_stored_value = task(std::forward<_Args>(args)...);
-					box.m_task_running.store(false);
-				};
-				m_next_task_ptr--;
-			}
-			else
-			{
-				*(m_task_buffer_end_ptr - 1) = [&]()
-				{
-					box.m_stored_value = task(std::forward<_Args>(args)...);
-					box.m_task_running.store(false);
-				};
-				m_next_task_ptr = m_task_buffer_end_ptr - 1;
-			}
+			*(m_ready_tasks_ptr + ready_end) = k;
+			ready_end++;
 		}
-		catch (...)
+	}
+	for (std::size_t ready_begin = 0; ready_begin < ready_end; ready_begin++)
+	{
+		graph_node* node_ptr = m_nodes_ptr + *(m_ready_tasks_ptr + ready_begin);
+		for (std::size_t n = 0; n < node_ptr->m_number_of_successors; n++)
 		{
-			m_waiting_tasks.fetch_sub(1, std::memory_order_release);
-			m_unfinished_tasks.fetch_sub(1, std::memory_order_release);
-			box.m_task_running.store(false, std::memory_order_release);
-			box.m_task_denied.store(true, std::memory_order_release);
-			return false;
+			std::size_t next_task_index = *(m_successors_ptr + node_ptr->m_first_successor + n);
+			if ((m_nodes_ptr + next_task_index)->m_pending_predecessors.fetch_sub(1, std::memory_order_relaxed) == 1)
+			{
+				*(m_ready_tasks_ptr + ready_end) = next_task_index;
+				ready_end++;
+			}
 		}
+	}
+
+	m_graph_sorted = (ready_end == m_number_of_tasks);
+	return m_graph_sorted;
+}
 
-		m_condition_var.notify_one();
+template <class threads_Ty>
+void welp::task_graph<threads_Ty>::queue_task_sub(std::size_t task_index)
+{
+	task_cell new_task;
+	new_task.store(node_task(this, task_index), static_cast<typename threads_Ty::allocator_type&>(*this));
+	m_pool_ptr->force_push_task_sub(new_task, m_pool_ptr->m_number_of_levels - 1);
+}
 
-#ifdef WELP_THREADS_DEBUG_MODE
-		if (m_DEBUG_record_on)
+template <class threads_Ty>
+void welp::task_graph<threads_Ty>::run_task_sub(std::size_t task_index)
+{
+	graph_node* node_ptr = m_nodes_ptr + task_index;
+	node_ptr->m_task.invoke();
+
+	for (std::size_t n = 0; n < node_ptr->m_number_of_successors; n++)
+	{
+		std::size_t next_task_index = *(m_successors_ptr + node_ptr->m_first_successor + n);
+		if ((m_nodes_ptr + next_task_index)->m_pending_predecessors.fetch_sub(1, std::memory_order_acq_rel) == 1)
 		{
-			m_DEBUG_record_accepted_task_count++;
-			std::size_t temp = m_waiting_tasks.load();
-			if (temp > m_DEBUG_record_max_occupancy.load())
-			{
-				m_DEBUG_record_max_occupancy.store(temp);
-			}
+			queue_task_sub(next_task_index);
 		}
-#endif // WELP_THREADS_DEBUG_MODE
-
-		return true;
 	}
-	else
+
+	const void* address = &m_remaining_tasks;
+	if (m_remaining_tasks.fetch_sub(1, std::memory_order_acq_rel) == 1)
 	{
-		box.m_task_denied.store(true, std::memory_order_release);
-		return false;
+		threads_Ty::wait_type::notify_all(address);
 	}
 }
 